@@ -1,18 +1,20 @@
 #include <vector>
 #include <iostream>
 #include <exception>
+#include <stdexcept>
+#include <algorithm>
 
+// indexed d-ary min heap. every value is tied to a key index ki in [0, max_size) so it can
+// be looked up, updated or removed in O(log_d n). T is the value type, D the arity: wider
+// heaps are shallower, which favours decrease heavy workloads like dijkstra
+template <typename T, int D = 4>
 class MinIndexedDHeap {
+    static_assert(D >= 2, "heap arity must be at least 2");
+
 private:
-    
     int size_ = 0;
 
-    // more efficient to preallocate
-    int max_size_; 
-
-    int degree_;
-
-    std::vector<int> child_, parent_;
+    int max_size_;
 
     // position map: ki -> node #
     std::vector<int> pm_;
@@ -20,62 +22,52 @@ private:
     // inverse map: node # -> ki
     std::vector<int> im_;
 
-    std::vector<int> values_; // assume input will be integers (can template this)
+    // indexed by ki
+    std::vector<T> values_;
 
-    void keyExistsOrThrow(int ki) {
+    void keyExistsOrThrow(int ki) const {
         if (contains(ki) == false)
             throw std::invalid_argument("ki does not exist");
     }
 
-    void keyInBoundsOrThrow(int ki) {
+    void keyInBoundsOrThrow(int ki) const {
         if (ki < 0 || ki >= max_size_)
             throw std::range_error("ki value out of range");
     }
 
-    void valueNotNullOrThrow(int value) {
-        if (value == -1)
-            throw std::invalid_argument("value is invalid");
-    }
-
-    void keyExistsAndValueNotNullOrThrow(int ki, int value) {
-        keyExistsOrThrow(ki);
-        valueNotNullOrThrow(value);
+    void isNotEmptyOrThrow() const {
+        if (isEmpty())
+            throw std::domain_error("heap is empty");
     }
 
-    bool less(int node_num_a, int node_num_b) {
+    bool less(int node_num_a, int node_num_b) const {
         return values_[im_[node_num_a]] < values_[im_[node_num_b]];
     }
 
     void swap(int node_num_a, int node_num_b) {
-        // swap position map values
-        pm_[im_[node_num_a]] = node_num_b;
-        pm_[im_[node_num_b]] = node_num_a;
-
-        // swap inverse map values
-        int tmp = im_[node_num_a] ;
-        im_[node_num_a] = im_[node_num_b];
-        im_[node_num_b] = tmp;
+        std::swap(pm_[im_[node_num_a]], pm_[im_[node_num_b]]);
+        std::swap(im_[node_num_a], im_[node_num_b]);
+    }
 
-        // // more elegant
-        // std::swap(pm_[im_[node_num_a]],  pm_[im_[node_num_b]]);
-        // std::swap(im_[node_num_a],  im_[node_num_b]);
+    static int parent(int node_num) {
+        return (node_num - 1) / D;
     }
 
-    // bubble up 
+    // bubble up
     void swim(int node_num) {
         // keep bubbling up node when it's less than its parent in value
-        while(less(node_num, parent_[node_num])) {
-            swap(node_num, parent_[node_num]);
-            node_num = parent_[node_num];
+        while (node_num > 0 && less(node_num, parent(node_num))) {
+            swap(node_num, parent(node_num));
+            node_num = parent(node_num);
         }
     }
 
     // find minimum child below node_num
-    // returns -1 if no child found
-    int minChild(int node_num) {
+    // returns -1 if no child is smaller than node_num
+    int minChild(int node_num) const {
         int smallest_child = -1;
-        int from = child_[node_num];
-        int to = std::min(size_, from + degree_);
+        int from = node_num * D + 1;
+        int to = std::min(size_, from + D);
         for (int kid = from; kid < to; ++kid) {
             if (less(kid, node_num)) {
                 smallest_child = kid;
@@ -85,53 +77,35 @@ private:
         return smallest_child;
     }
 
-    // keep swapping a node with its smallest child 
+    // keep swapping a node with its smallest child
     void sink(int node_num) {
-        for (int child = minChild(node_num); child != -1; ) {
+        for (int child = minChild(node_num); child != -1; child = minChild(node_num)) {
             swap(node_num, child);
             node_num = child;
-            child = minChild(node_num); // or child = minChild(child)
         }
     }
 
-    void isNotEmptyOrThrow() {
-        if (isEmpty())
-            throw std::domain_error("heap is empty");
-    }
-
 public:
-    MinIndexedDHeap(int degree, int max_size) {
-        degree_ = std::max(2, degree);
-        max_size_ = std::max(degree_ + 1, max_size_);
-
-        child_.resize(max_size_);
-        parent_.resize(max_size_);
-        pm_.resize(max_size_);
-        im_.resize(max_size_);
+    MinIndexedDHeap(int max_size) : max_size_(std::max(0, max_size)) {
+        pm_.assign(max_size_, -1);
+        im_.assign(max_size_, -1);
         values_.resize(max_size_);
-
-        for (int i = 0; i < max_size_; ++i) {
-            parent_[i] = (i - 1) / degree_;
-            child_[i] = i * degree_ + 1;
-            pm_[i] = -1;
-            im_[i] = -1;
-        }
     }
 
-    int size() {
+    int size() const {
         return size_;
     }
 
-    bool isEmpty() {
+    bool isEmpty() const {
         return size_ == 0;
     }
 
-    bool contains(int ki) {
+    bool contains(int ki) const {
         keyInBoundsOrThrow(ki);
         return pm_[ki] != -1;
     }
 
-    int peekMinKeyIndex() {
+    int peekMinKeyIndex() const {
         isNotEmptyOrThrow();
         return im_[0];
     }
@@ -142,55 +116,54 @@ public:
         return min_ki;
     }
 
-    int peekMinValue() {
+    T peekMinValue() const {
         isNotEmptyOrThrow();
         return values_[im_[0]];
     }
 
-    int pollMinValue() {
-        int min_value = peekMinValue();
+    T pollMinValue() {
+        T min_value = peekMinValue();
         remove(peekMinKeyIndex());
         return min_value;
     }
 
-    void insert(int ki, int value) {
+    void insert(int ki, T value) {
         if (contains(ki))
             throw std::invalid_argument("ki already in use");
 
         pm_[ki] = size_;
         im_[size_] = ki;
         values_[ki] = value;
-        swim(size_);
-        ++size_;
+        swim(size_++);
     }
 
-    int valueOf(int ki) {
+    T valueOf(int ki) const {
         keyExistsOrThrow(ki);
-        values_[ki];
+        return values_[ki];
     }
 
-    int remove(int ki) {
+    T remove(int ki) {
         keyExistsOrThrow(ki);
         int node_num = pm_[ki];
 
         // swap node for ki with element at the end of heap
-        // make node move up or down, depending on value
+        // make the element now at node_num move up or down, depending on value
         swap(node_num, --size_);
-        sink(node_num);
-        swim(node_num);
+        if (node_num != size_) {
+            sink(node_num);
+            swim(node_num);
+        }
 
         // clean up arrays and return value
-        int value = values_[ki];
-        values_[ki] = -1;
         pm_[ki] = -1;
         im_[size_] = -1;
-        return value;
+        return values_[ki];
     }
 
-    int update(int ki, int value) {
-        keyExistsAndValueNotNullOrThrow(ki, value);
+    T update(int ki, T value) {
+        keyExistsOrThrow(ki);
         int node_num = pm_[ki];
-        int old_value = values_[ki];
+        T old_value = values_[ki];
 
         // update value of node, move it up/down accordingly
         values_[ki] = value;
@@ -200,28 +173,50 @@ public:
         return old_value;
     }
 
-    void decrease(int ki, int value) {
-        keyExistsAndValueNotNullOrThrow(ki, value);
-        if (less(value, values_[ki])) {
+    void decrease(int ki, T value) {
+        keyExistsOrThrow(ki);
+        if (value < values_[ki]) {
             values_[ki] = value;
             swim(pm_[ki]);
         }
     }
 
-    void increase(int ki, int value) {
-        keyExistsAndValueNotNullOrThrow(ki, value);
-        if (less(values_[ki], value)) {
+    void increase(int ki, T value) {
+        keyExistsOrThrow(ki);
+        if (values_[ki] < value) {
             values_[ki] = value;
             sink(pm_[ki]);
         }
     }
 
+    // O(size) instead of O(max_size)
+    void clear() {
+        for (int i = 0; i < size_; ++i) {
+            pm_[im_[i]] = -1;
+            im_[i] = -1;
+        }
+        size_ = 0;
+    }
+
 };
 
 
 int main() {
 
-    MinIndexedDHeap min_heap(2, 10);
+    MinIndexedDHeap<double, 4> min_heap(10);
+    min_heap.insert(3, 2.5);
+    min_heap.insert(7, 1.0);
+    min_heap.insert(1, 4.0);
+    min_heap.insert(5, 3.0);
+    min_heap.decrease(1, 0.5);
+    min_heap.increase(7, 5.0);
+
+    // keys in order of value: 1 3 5 7
+    while (min_heap.isEmpty() == false) {
+        int ki = min_heap.peekMinKeyIndex();
+        std::cout << ki << " (" << min_heap.pollMinValue() << ") ";
+    }
+    std::cout << std::endl;
 
     return 0;
-}
\ No newline at end of file
+}
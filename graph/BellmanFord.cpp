@@ -1,6 +1,19 @@
 #include <iostream>
 #include <vector>
 #include <limits> 
+#include <deque>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <math.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 
 struct Edge {
@@ -10,15 +23,291 @@ struct Edge {
 };
 
 
-std::vector<double> bellmanFord(const std::vector<Edge>& edges, int num_vertices, int start) {
+struct SpfaStats {
+    // how often each node's cost to come went down
+    std::vector<int> relaxations;
+
+    // nodes taken off the queue and scanned
+    long scans = 0;
+
+    // walks over the predecessor graph
+    int cycle_checks = 0;
+
+    int negative_cycles = 0;
+};
+
+struct NegativeCycle {
+    // cycle order, the last node has an edge back to the first
+    std::vector<int> nodes;
+    double weight;
+};
+
+// what spfaSearch keeps per node besides the cost to come, packed so an improving relaxation
+// touches one cache line. the costs themselves stay in their own array: the relax check reads
+// nothing else, and at 8 bytes a node they stay in cache far longer
+struct SpfaNode {
+    // predecessor and the arc from it, -1 for none
+    int prev;
+    int prev_arc;
+
+    int relaxations;
+
+    // IN_QUEUE | DEAD
+    int flags;
+};
+
+// queue based bellman ford (shortest path faster algorithm). only nodes whose cost to come just
+// went down are scanned, in fifo order. small label first (a node cheaper than the front goes
+// ahead of it) and large label last (rotating the front while it is above the queue's average)
+// are optional: on random graphs both scan more nodes or spend more on bookkeeping than they save.
+//
+// negative cycles are caught by walking the predecessor graph every V relaxations, O(V) per walk
+// so it adds O(1) per relaxation. a cycle of predecessors always has negative weight, and once
+// a negative cycle is reachable one turns up after a finite number of passes.
+// without cycles (spfa) everything reachable from a negative cycle is set to -max and dropped,
+// the rest is solved exactly. with cycles only the cycle itself is dropped and the search keeps
+// going until max_cycles are found. start == -1 starts every node at 0, as if a virtual source
+// reached all of them
+std::vector<double> spfaSearch(const std::vector<Edge>& edges, int num_vertices, int start, SpfaStats* stats,
+                               std::vector<NegativeCycle>* cycles, int max_cycles, bool small_label_first,
+                               bool large_label_last) {
+    const int n = num_vertices;
+    const double NEG_INF = -std::numeric_limits<double>::max();
+    const int IN_QUEUE = 1, DEAD = 2;
+
+    // csr: the arcs of u are [offsets[u], offsets[u + 1])
+    std::vector<int> offsets(n + 1, 0), arc_to(edges.size());
+    std::vector<double> arc_cost(edges.size());
+    for (const Edge& edge : edges)
+        ++offsets[edge.from + 1];
+    for (int node = 0; node < n; ++node)
+        offsets[node + 1] += offsets[node];
+    {
+        std::vector<int> pos(offsets.begin(), offsets.end() - 1);
+        for (const auto [from, to, cost] : edges) {
+            arc_to[pos[from]] = to;
+            arc_cost[pos[from]++] = cost;
+        }
+    }
+
+    std::vector<double> cost_to_come(n, std::numeric_limits<double>::infinity());
+    std::vector<SpfaNode> nodes(n, {-1, -1, 0, 0});
+    SpfaNode* state = nodes.data();
+    double* cost = cost_to_come.data();
+
+    long scans = 0;
+    int cycle_checks = 0;
+    int negative_cycles = 0;
+
+    // ring buffer queue, a node is in it at most once so n slots do.
+    // sum and count of the live entries are only kept for large label last
+    std::vector<int> ring(std::max(1, n));
+    int head = 0, size = 0;
+    double sum = 0;
+    int count = 0;
+
+    auto push = [&](int node) {
+        if (small_label_first && size > 0 && cost[node] < cost[ring[head]]) {
+            head = (head == 0) ? n - 1 : head - 1;
+            ring[head] = node;
+        } else {
+            int tail = head + size;
+            ring[(tail >= n) ? tail - n : tail] = node;
+        }
+        ++size;
+        state[node].flags |= IN_QUEUE;
+        if (large_label_last) {
+            sum += cost[node];
+            ++count;
+        }
+    };
+    auto popFront = [&]() {
+        int node = ring[head];
+        head = (head + 1 == n) ? 0 : head + 1;
+        --size;
+        return node;
+    };
+
+    // nothing improves on -max, so relaxing doesn't need to look at DEAD
+    auto drop = [&](int node) {
+        SpfaNode& s = state[node];
+        s.flags |= DEAD;
+        if (s.flags & IN_QUEUE) {
+            s.flags &= ~IN_QUEUE;
+            if (large_label_last) {
+                sum -= cost[node];
+                --count;
+            }
+        }
+        cost[node] = NEG_INF;
+    };
+
+    // everything reachable from a negative cycle has cost -max
+    auto killReachable = [&](int from) {
+        std::vector<int> stack = {from};
+        state[from].flags |= DEAD;
+        while (stack.empty() == false) {
+            int node = stack.back();
+            stack.pop_back();
+            drop(node);
+            for (int i = offsets[node]; i < offsets[node + 1]; ++i) {
+                int to = arc_to[i];
+                if ((state[to].flags & DEAD) == 0) {
+                    state[to].flags |= DEAD;
+                    stack.push_back(to);
+                }
+            }
+        }
+    };
+
+    auto predecessor = [&](int node) {
+        return (state[node].flags & DEAD) ? -1 : state[node].prev;
+    };
+
+    // walks up the predecessors from every node, a walk that runs into itself found a cycle.
+    // nodes keep the id of the walk that reached them so each is visited once per check
+    std::vector<long> walk(n, 0);
+    long walk_id = 0;
+    bool done = false;
+
+    auto checkCycles = [&]() {
+        ++cycle_checks;
+        long first_walk = walk_id + 1;
+        for (int from = 0; from < n && done == false; ++from) {
+            if (walk[from] >= first_walk)
+                continue;
+            ++walk_id;
+            int node = from;
+            while (node != -1 && walk[node] < first_walk) {
+                walk[node] = walk_id;
+                node = predecessor(node);
+            }
+            if (node == -1 || walk[node] != walk_id)
+                continue;
+
+            // node is on a cycle of predecessors, read it off backwards
+            ++negative_cycles;
+            if (cycles == nullptr) {
+                killReachable(node);
+                continue;
+            }
+
+            NegativeCycle cycle;
+            cycle.weight = 0;
+            int at = node;
+            do {
+                cycle.nodes.push_back(at);
+                cycle.weight += arc_cost[state[at].prev_arc];
+                at = state[at].prev;
+            } while (at != node);
+            std::reverse(cycle.nodes.begin(), cycle.nodes.end());
+
+            for (int cycle_node : cycle.nodes)
+                drop(cycle_node);
+            cycles->push_back(std::move(cycle));
+            done = (int)cycles->size() >= max_cycles;
+        }
+    };
+
+    if (start == -1) {
+        for (int node = 0; node < n; ++node) {
+            cost[node] = 0;
+            push(node);
+        }
+    } else {
+        cost[start] = 0;
+        push(start);
+    }
+
+    long relaxations_since_check = 0;
+    while (size > 0 && done == false) {
+        // large label last, bounded so a stale front can't spin forever
+        for (int turns = 0; large_label_last && turns < size && count > 0; ++turns) {
+            int front = ring[head];
+            if ((state[front].flags & IN_QUEUE) == 0 || cost[front] * count <= sum)
+                break;
+            popFront();
+            int tail = head + size;
+            ring[(tail >= n) ? tail - n : tail] = front;
+            ++size;
+        }
+
+        int u = popFront();
+        SpfaNode& su = state[u];
+        if ((su.flags & IN_QUEUE) == 0)
+            continue;
+        su.flags &= ~IN_QUEUE;
+        if (large_label_last) {
+            sum -= cost[u];
+            --count;
+        }
+        ++scans;
+
+        double cost_u = cost[u];
+        for (int a = offsets[u]; a < offsets[u + 1]; ++a) {
+            int v = arc_to[a];
+            double new_cost = cost_u + arc_cost[a];
+            if (new_cost >= cost[v])
+                continue;
+
+            SpfaNode& sv = state[v];
+            sv.prev = u;
+            sv.prev_arc = a;
+            ++sv.relaxations;
+            ++relaxations_since_check;
+            if (large_label_last && (sv.flags & IN_QUEUE))
+                sum -= cost[v] - new_cost;
+            cost[v] = new_cost;
+            if ((sv.flags & IN_QUEUE) == 0)
+                push(v);
+        }
+
+        if (relaxations_since_check >= n) {
+            relaxations_since_check = 0;
+            checkCycles();
+        }
+    }
+
+    if (stats != nullptr) {
+        stats->relaxations.resize(n);
+        for (int node = 0; node < n; ++node)
+            stats->relaxations[node] = state[node].relaxations;
+        stats->scans = scans;
+        stats->cycle_checks = cycle_checks;
+        stats->negative_cycles = negative_cycles;
+    }
+    return cost_to_come;
+}
+
+// same output as bellmanFord
+std::vector<double> spfa(const std::vector<Edge>& edges, int num_vertices, int start, SpfaStats* stats = nullptr,
+                         bool small_label_first = false, bool large_label_last = false) {
+    return spfaSearch(edges, num_vertices, start, stats, nullptr, 0, small_label_first, large_label_last);
+}
+
+// up to max_cycles node disjoint negative cycles, anywhere in the graph or only among nodes
+// reachable from start. the search stops at the max_cycles'th cycle, e.g. an arbitrage detector
+// on -log(rate) edges can ask for the first one and act on it
+std::vector<NegativeCycle> findNegativeCycles(const std::vector<Edge>& edges, int num_vertices,
+                                              int max_cycles, int start = -1) {
+    std::vector<NegativeCycle> cycles;
+    if (max_cycles > 0)
+        spfaSearch(edges, num_vertices, start, nullptr, &cycles, max_cycles, false, false);
+    return cycles;
+}
+
+// passes (if given) gets the number of sweeps over the edges
+std::vector<double> bellmanFord(const std::vector<Edge>& edges, int num_vertices, int start, int* passes = nullptr) {
     std::vector<double> cost_to_come(num_vertices, std::numeric_limits<double>::infinity());
     cost_to_come[start] = 0;
+    int num_passes = 0;
 
     bool relaxed_an_edge = true; // early stopping condition when no edges relaxed
 
     // for each vertex, relax edge
     for (int v = 0; v < num_vertices - 1 && relaxed_an_edge; v++) {
         relaxed_an_edge = false;
+        ++num_passes;
         for (const auto [from, to, cost] : edges) {
             if (cost_to_come[from] + cost < cost_to_come[to]) {
                 cost_to_come[to] = cost_to_come[from] + cost;
@@ -29,8 +318,9 @@ std::vector<double> bellmanFord(const std::vector<Edge>& edges, int num_vertices
 
     // run second time to detect negative cycles
     relaxed_an_edge = true;
-    for (int v = 0; v < num_vertices - 1 && relaxed_an_edge; v++) {
+    for (int v = 0; v < num_vertices && relaxed_an_edge; v++) {
         relaxed_an_edge = false;
+        ++num_passes;
         for (const auto [from, to, cost] : edges) {
             if (cost_to_come[from] + cost < cost_to_come[to]) {
                 cost_to_come[to] = -std::numeric_limits<double>::max();
@@ -39,11 +329,311 @@ std::vector<double> bellmanFord(const std::vector<Edge>& edges, int num_vertices
         }
     }
 
+    if (passes != nullptr)
+        *passes = num_passes;
+    return cost_to_come;
+
+}
+
+
+
+// see graph/Dijkstra.cpp
+class ThreadPool {
+private:
+    int num_threads_;
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable start_, done_;
+    std::function<void(int)> job_;
+    unsigned generation_ = 0;
+    int running_ = 0;
+    bool stop_ = false;
+
+    void workerLoop(int thread_id) {
+        unsigned seen = 0;
+        while (true) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_)
+                return;
+            seen = generation_;
+            lock.unlock();
+
+            job_(thread_id);
+
+            lock.lock();
+            if (--running_ == 0)
+                done_.notify_one();
+        }
+    }
+
+public:
+    ThreadPool(int num_threads) : num_threads_(std::max(1, num_threads)) {
+        // the calling thread is worker 0
+        for (int t = 1; t < num_threads_; ++t)
+            workers_.emplace_back(&ThreadPool::workerLoop, this, t);
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    int size() const {
+        return num_threads_;
+    }
+
+    // runs job(thread_id) on every thread and returns once all of them are done
+    void run(const std::function<void(int)>& job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = job;
+            running_ = num_threads_ - 1;
+            ++generation_;
+        }
+        start_.notify_all();
+
+        job(0);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [&] { return running_ == 0; });
+    }
+};
+
+// edges as separate arrays sorted by destination, the in edges of node v are
+// [offsets[v], offsets[v + 1]) so the destination itself doesn't need storing
+struct EdgeArrays {
+    int num_vertices;
+    std::vector<int> offsets;
+    std::vector<int> from;
+    std::vector<double> cost;
+
+    EdgeArrays(const std::vector<Edge>& edges, int num_vertices) :
+        num_vertices(num_vertices), offsets(num_vertices + 1, 0), from(edges.size()), cost(edges.size()) {
+        for (const Edge& edge : edges)
+            ++offsets[edge.to + 1];
+        for (int node = 0; node < num_vertices; ++node)
+            offsets[node + 1] += offsets[node];
+        std::vector<int> pos(offsets.begin(), offsets.end() - 1);
+        for (const auto [edge_from, edge_to, edge_cost] : edges) {
+            from[pos[edge_to]] = edge_from;
+            cost[pos[edge_to]++] = edge_cost;
+        }
+    }
+};
+
+// out[i] = cost_to_come[from[i]] + cost[i]. the avx2 gather is only compiled in when the
+// compiler targets it, which the default flags don't: configure with
+// cmake -DCMAKE_CXX_FLAGS="-O2 -march=native" (or -mavx2) to get it
+void gatherCosts(const double* cost_to_come, const int* from, const double* cost, double* out, int count) {
+    int i = 0;
+#if defined(__AVX2__)
+    for (; i + 4 <= count; i += 4) {
+        __m128i index = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i));
+        __m256d gathered = _mm256_i32gather_pd(cost_to_come, index, 8);
+        _mm256_storeu_pd(out + i, _mm256_add_pd(gathered, _mm256_loadu_pd(cost + i)));
+    }
+#endif
+    for (; i < count; ++i)
+        out[i] = cost_to_come[from[i]] + cost[i];
+}
+
+// bellman ford with the nodes split into one slice per thread, balanced by in edges. every
+// pass reads last pass' costs and writes the next ones (jacobi rather than gauss seidel), so
+// a thread only ever writes its own slice, there are no atomics, and the result doesn't depend
+// on the number of threads. jacobi needs more passes than the serial sweep, which sees this
+// pass' improvements straight away, so a single thread is slower than bellmanFord and it takes
+// a few threads to break even. each pass is cheap though: the costs of a block of in edges are
+// gathered in one go (avx2 when the build has it) and then reduced per node. same output as
+// bellmanFord, passes (if given) gets the number of passes run
+std::vector<double> bellmanFordParallel(const EdgeArrays& graph, int start, int num_threads,
+                                        int* passes = nullptr) {
+    const int n = graph.num_vertices;
+    const int CHUNK = 1024;
+
+    std::vector<double> cost_to_come(n, std::numeric_limits<double>::infinity());
+    cost_to_come[start] = 0;
+    std::vector<double> next_cost_to_come = cost_to_come;
+
+    ThreadPool pool(num_threads);
+    num_threads = pool.size();
+
+    // slice t is [bounds[t], bounds[t + 1]), cut where nodes + in edges so far reach t / num_threads
+    std::vector<int> bounds(num_threads + 1, n);
+    bounds[0] = 0;
+    long total = (long)n + graph.offsets[n];
+    for (int t = 1, node = 0; t < num_threads; ++t) {
+        while (node < n && (long)node + graph.offsets[node] < total * t / num_threads)
+            ++node;
+        bounds[t] = node;
+    }
+
+    std::vector<std::vector<double>> scratch(num_threads);
+    std::vector<char> changed(num_threads);
+    int num_passes = 0;
+
+    // one jacobi pass, or with to_negative_infinity one pass of spreading -max from
+    // anything that can still be relaxed
+    auto pass = [&](bool to_negative_infinity) {
+        pool.run([&](int t) {
+            const double* current = cost_to_come.data();
+            double* next = next_cost_to_come.data();
+            std::vector<double>& candidates = scratch[t];
+            bool any = false;
+
+            for (int node = bounds[t]; node < bounds[t + 1]; ) {
+                // nodes whose in edges fit in a chunk, at least one
+                int begin = graph.offsets[node];
+                int node_end = node + 1;
+                while (node_end < bounds[t + 1] && graph.offsets[node_end + 1] - begin <= CHUNK)
+                    ++node_end;
+                int end = graph.offsets[node_end];
+
+                candidates.resize(std::max<size_t>(candidates.size(), end - begin));
+                gatherCosts(current, graph.from.data() + begin, graph.cost.data() + begin, candidates.data(), end - begin);
+
+                for (int v = node; v < node_end; ++v) {
+                    double best = current[v];
+                    for (int i = graph.offsets[v]; i < graph.offsets[v + 1]; ++i)
+                        best = std::min(best, candidates[i - begin]);
+                    if (best < current[v]) {
+                        any = true;
+                        best = to_negative_infinity ? -std::numeric_limits<double>::max() : best;
+                    }
+                    next[v] = best;
+                }
+                node = node_end;
+            }
+            changed[t] = any;
+        });
+
+        cost_to_come.swap(next_cost_to_come);
+        ++num_passes;
+        return std::find(changed.begin(), changed.end(), true) != changed.end();
+    };
+
+    bool relaxed_an_edge = true;
+    for (int v = 0; v < n - 1 && relaxed_an_edge; ++v)
+        relaxed_an_edge = pass(false);
+
+    // anything still improving is reachable from a negative cycle
+    relaxed_an_edge = true;
+    for (int v = 0; v < n && relaxed_an_edge; ++v)
+        relaxed_an_edge = pass(true);
+
+    if (passes != nullptr)
+        *passes = num_passes;
     return cost_to_come;
+}
 
+std::vector<double> bellmanFordParallel(const std::vector<Edge>& edges, int num_vertices, int start, int num_threads,
+                                        int* passes = nullptr) {
+    return bellmanFordParallel(EdgeArrays(edges, num_vertices), start, num_threads, passes);
 }
 
+void testArbitrage() {
+    // exchange rates, an edge of weight -log(rate) per pair so a cycle of negative weight
+    // multiplies out to more than 1
+    std::vector<std::string> currencies = {"USD", "EUR", "GBP", "JPY"};
+    std::vector<std::vector<double>> rates = {
+        {1, 0.92, 0.79, 150.0},
+        {1.09, 1, 0.86, 163.0},
+        {1.27, 1.17, 1, 190.0},
+        {0.0067, 0.0062, 0.0052, 1}
+    };
 
+    std::vector<Edge> edges;
+    for (int from = 0; from < 4; ++from)
+        for (int to = 0; to < 4; ++to)
+            if (from != to)
+                edges.push_back({from, to, -std::log(rates[from][to])});
+
+    // the first cycle closed is printed, other cycles (GBP -> JPY -> USD -> GBP) are left alone
+    // Output:
+    // JPY -> USD -> JPY multiplies to 1.005
+    for (const NegativeCycle& cycle : findNegativeCycles(edges, 4, 1)) {
+        for (int node : cycle.nodes)
+            std::cout << currencies[node] << " -> ";
+        std::cout << currencies[cycle.nodes[0]] << " multiplies to " << std::exp(-cycle.weight) << std::endl;
+    }
+}
+
+// the last tail_length nodes hang off the rest as a chain, each only reachable from the one
+// after it, listed against the sweep order. the random part settles in a few passes but the
+// sweeps keep going one hop of the tail per pass, the case spfa is for
+void benchmarkBellmanFord(int num_vertices, int degree, int tail_length) {
+    // non negative weights shifted by random potentials: plenty of negative edges but no
+    // negative cycles, like an arbitrage graph in a calm market
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> weight(0, 1), potential(0, 10);
+    std::vector<double> p(num_vertices);
+    for (double& value : p)
+        value = potential(rng);
+
+    int core = num_vertices - tail_length;
+    std::vector<Edge> edges;
+    for (int from = 0; from < num_vertices; ++from) {
+        if (from > core) {
+            edges.push_back({from, from - 1, weight(rng) + p[from] - p[from - 1]});
+            continue;
+        }
+        for (int d = 0; d < degree; ++d) {
+            int to = rng() % num_vertices;
+            if (to >= core)
+                to = num_vertices - 1;
+            edges.push_back({from, to, weight(rng) + p[from] - p[to]});
+        }
+    }
+
+    auto ms = [](auto a, auto b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+    auto t0 = std::chrono::steady_clock::now();
+    int sweep_passes = 0;
+    auto sweep = bellmanFord(edges, num_vertices, 0, &sweep_passes);
+    auto t1 = std::chrono::steady_clock::now();
+    SpfaStats stats;
+    auto queued = spfa(edges, num_vertices, 0, &stats);
+    auto t2 = std::chrono::steady_clock::now();
+
+    auto countDifferent = [&](const std::vector<double>& other) {
+        int different = 0;
+        for (int node = 0; node < num_vertices; ++node)
+            different += std::abs(sweep[node] - other[node]) > 1e-9 && sweep[node] != other[node];
+        return different;
+    };
+
+    std::cout << num_vertices << " nodes, " << tail_length << " of them in the tail" << std::endl;
+    std::cout << "sweeps " << ms(t0, t1) << " ms (" << sweep_passes << " passes), spfa " << ms(t1, t2) << " ms (" << stats.scans
+              << " scans), different costs: " << countDifferent(queued) << std::endl;
+
+    EdgeArrays graph(edges, num_vertices);
+    std::vector<double> first;
+    double one_thread_ms = 0;
+    for (int threads : {1, 2, 4}) {
+        int passes = 0;
+        auto t3 = std::chrono::steady_clock::now();
+        auto parallel = bellmanFordParallel(graph, 0, threads, &passes);
+        auto t4 = std::chrono::steady_clock::now();
+        if (first.empty()) {
+            first = parallel;
+            one_thread_ms = ms(t3, t4);
+        }
+        std::cout << "parallel with " << threads << " threads " << ms(t3, t4) << " ms (" << passes
+                  << " passes), different costs: " << countDifferent(parallel)
+                  << ", same as 1 thread: " << (parallel == first) << std::endl;
+    }
+
+    // the timings above only scale on a machine with the cores for it, so estimate where the
+    // parallel version catches up with the sweeps from its 1 thread time, assuming linear scaling
+    std::cout << "parallel breaks even with the sweeps at about "
+              << std::max(1, (int)std::ceil(one_thread_ms / ms(t0, t1))) << " threads ("
+              << std::thread::hardware_concurrency() << " on this machine)" << std::endl;
+}
 
 int main() {
     int E = 10;
@@ -82,5 +672,24 @@ int main() {
     // The cost to get from node 0 to 7 is 8.00
     // The cost to get from node 0 to 8 is Infinity
 
+    SpfaStats stats;
+    auto spfa_cost_to_come = spfa(edges, V, start, &stats);
+    std::cout << "spfa agrees with the sweeps: " << (spfa_cost_to_come == cost_to_come)
+              << ", negative cycles found: " << stats.negative_cycles << std::endl;
+
+    std::cout << "parallel agrees with the sweeps: " << (bellmanFordParallel(edges, V, start, 2) == cost_to_come) << std::endl;
+
+    // 2 -> 4 -> 3 has weight -1
+    for (const NegativeCycle& cycle : findNegativeCycles(edges, V, 10, start)) {
+        for (int node : cycle.nodes)
+            std::cout << node << " -> ";
+        std::cout << cycle.nodes[0] << " has weight " << cycle.weight << std::endl;
+    }
+
+    testArbitrage();
+
+    benchmarkBellmanFord(100000, 5, 0);
+    benchmarkBellmanFord(100000, 5, 100);
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,357 @@
+#include <vector>
+#include <iostream>
+#include <limits>
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <stdexcept>
+
+// boykov kolmogorov max flow on an implicit 4 or 8 connected width x height grid.
+// there are no edge objects: every node has one residual capacity per direction,
+// stored in flat per direction arrays, plus a signed terminal capacity.
+// the source and sink search trees are kept between augmentations and repaired
+// by adopting orphans instead of being regrown from scratch
+class BoykovKolmogorovSolver {
+private:
+    // direction d and d ^ 1 are opposite
+    static constexpr int DX[8] = {1, -1, 0, 0, 1, -1, 1, -1};
+    static constexpr int DY[8] = {0, 0, 1, -1, 1, -1, -1, 1};
+
+    static constexpr char FREE = 0, SOURCE_TREE = 1, SINK_TREE = 2;
+
+    // parent_ is the direction towards the parent, or one of these
+    static constexpr int TERMINAL = -1, ORPHAN = -2, NONE = -3;
+
+    static constexpr int INF_DIST = std::numeric_limits<int>::max();
+
+    int width_, height_, n_, num_dirs_;
+
+    bool solved_ = false;
+    long max_flow_ = 0;
+
+    // capacity_[d][node] is the residual capacity of node -> its neighbour in direction d
+    std::vector<std::vector<long>> capacity_;
+
+    // source and sink capacities, folded into terminal_ when solving:
+    // positive means residual source -> node, negative means residual node -> sink
+    std::vector<long> source_cap_, sink_cap_, terminal_;
+
+    std::vector<char> tree_;
+    std::vector<int> parent_;
+
+    // time stamp and distance to the terminal, used to pick short origins when adopting
+    std::vector<int> ts_, dist_;
+    int time_ = 0;
+
+    std::deque<int> active_;
+    std::vector<char> is_active_;
+    std::vector<int> orphans_;
+
+    int neighbour(int node, int d) const {
+        int x = node % width_ + DX[d];
+        int y = node / width_ + DY[d];
+        if (x < 0 || x >= width_ || y < 0 || y >= height_)
+            return -1;
+        return y * width_ + x;
+    }
+
+    // residual capacity of the edge that would connect node to q inside node's tree,
+    // parent -> child in the source tree and child -> parent in the sink tree
+    long treeCapacity(int node, int d, int q) const {
+        return (tree_[node] == SOURCE_TREE) ? capacity_[d][node] : capacity_[d ^ 1][q];
+    }
+
+    void activate(int node) {
+        if (is_active_[node] == false) {
+            is_active_[node] = true;
+            active_.push_back(node);
+        }
+    }
+
+    void makeOrphan(int node) {
+        parent_[node] = ORPHAN;
+        orphans_.push_back(node);
+    }
+
+    // grows the trees from the first active node until they touch, returns the
+    // source tree endpoint and the direction from it to the sink tree endpoint
+    std::pair<int, int> grow() {
+        while (active_.empty() == false) {
+            int node = active_.front();
+            if (tree_[node] == FREE) {
+                active_.pop_front();
+                is_active_[node] = false;
+                continue;
+            }
+
+            for (int d = 0; d < num_dirs_; ++d) {
+                int q = neighbour(node, d);
+                if (q == -1 || treeCapacity(node, d, q) == 0)
+                    continue;
+
+                if (tree_[q] == FREE) {
+                    tree_[q] = tree_[node];
+                    parent_[q] = d ^ 1;
+                    ts_[q] = ts_[node];
+                    dist_[q] = dist_[node] + 1;
+                    activate(q);
+                } else if (tree_[q] != tree_[node]) {
+                    // node stays at the front so growth resumes from it after augmenting
+                    return (tree_[node] == SOURCE_TREE) ? std::make_pair(node, d) : std::make_pair(q, d ^ 1);
+                } else if (ts_[q] <= ts_[node] && dist_[q] > dist_[node]) {
+                    // shorter route to a terminal through node
+                    parent_[q] = d ^ 1;
+                    ts_[q] = ts_[node];
+                    dist_[q] = dist_[node] + 1;
+                }
+            }
+
+            active_.pop_front();
+            is_active_[node] = false;
+        }
+
+        return {-1, -1};
+    }
+
+    void augment(int s_end, int d) {
+        int t_end = neighbour(s_end, d);
+
+        // find bottle neck value
+        long bottle_neck = capacity_[d][s_end];
+        int node = s_end;
+        for (; parent_[node] != TERMINAL; node = neighbour(node, parent_[node]))
+            bottle_neck = std::min(bottle_neck, capacity_[parent_[node] ^ 1][neighbour(node, parent_[node])]);
+        bottle_neck = std::min(bottle_neck, terminal_[node]);
+
+        node = t_end;
+        for (; parent_[node] != TERMINAL; node = neighbour(node, parent_[node]))
+            bottle_neck = std::min(bottle_neck, capacity_[parent_[node]][node]);
+        bottle_neck = std::min(bottle_neck, -terminal_[node]);
+
+        // push flow, saturated tree edges turn their child into an orphan
+        capacity_[d][s_end] -= bottle_neck;
+        capacity_[d ^ 1][t_end] += bottle_neck;
+
+        for (node = s_end; parent_[node] != TERMINAL; ) {
+            int pd = parent_[node];
+            int parent = neighbour(node, pd);
+            capacity_[pd ^ 1][parent] -= bottle_neck;
+            capacity_[pd][node] += bottle_neck;
+            if (capacity_[pd ^ 1][parent] == 0)
+                makeOrphan(node);
+            node = parent;
+        }
+        terminal_[node] -= bottle_neck;
+        if (terminal_[node] == 0)
+            makeOrphan(node);
+
+        for (node = t_end; parent_[node] != TERMINAL; ) {
+            int pd = parent_[node];
+            int parent = neighbour(node, pd);
+            capacity_[pd][node] -= bottle_neck;
+            capacity_[pd ^ 1][parent] += bottle_neck;
+            if (capacity_[pd][node] == 0)
+                makeOrphan(node);
+            node = parent;
+        }
+        terminal_[node] += bottle_neck;
+        if (terminal_[node] == 0)
+            makeOrphan(node);
+
+        max_flow_ += bottle_neck;
+    }
+
+    // length of the path from node to its terminal, INF_DIST if it ends at an orphan.
+    // nodes on a valid path are stamped with the current time and their distance
+    int originDistance(int node) {
+        int d = 0;
+        int at = node;
+        while (true) {
+            if (ts_[at] == time_) {
+                d += dist_[at];
+                break;
+            }
+            if (parent_[at] == TERMINAL) {
+                ts_[at] = time_;
+                dist_[at] = 1;
+                d += 1;
+                break;
+            }
+            if (parent_[at] < 0)
+                return INF_DIST;
+            ++d;
+            at = neighbour(at, parent_[at]);
+        }
+
+        for (int k = d, at = node; ts_[at] != time_; at = neighbour(at, parent_[at])) {
+            ts_[at] = time_;
+            dist_[at] = k--;
+        }
+        return d;
+    }
+
+    void adopt(int node) {
+        int best_dir = -1, best_dist = INF_DIST;
+        for (int d = 0; d < num_dirs_; ++d) {
+            int q = neighbour(node, d);
+            if (q == -1 || tree_[q] != tree_[node])
+                continue;
+
+            // the edge between q (new parent) and node must have residual capacity
+            long cap = (tree_[node] == SOURCE_TREE) ? capacity_[d ^ 1][q] : capacity_[d][node];
+            if (cap == 0)
+                continue;
+
+            int dist = originDistance(q);
+            if (dist < best_dist) {
+                best_dist = dist;
+                best_dir = d;
+            }
+        }
+
+        if (best_dir != -1) {
+            parent_[node] = best_dir;
+            ts_[node] = time_;
+            dist_[node] = best_dist + 1;
+            return;
+        }
+
+        // no valid parent, node leaves its tree
+        for (int d = 0; d < num_dirs_; ++d) {
+            int q = neighbour(node, d);
+            if (q == -1 || tree_[q] != tree_[node])
+                continue;
+
+            long cap = (tree_[node] == SOURCE_TREE) ? capacity_[d ^ 1][q] : capacity_[d][node];
+            if (cap > 0)
+                activate(q);
+            if (parent_[q] >= 0 && neighbour(q, parent_[q]) == node)
+                makeOrphan(q);
+        }
+        tree_[node] = FREE;
+        parent_[node] = NONE;
+    }
+
+    void solve() {
+        terminal_.resize(n_);
+        tree_.assign(n_, FREE);
+        parent_.assign(n_, NONE);
+        ts_.assign(n_, 0);
+        dist_.assign(n_, 0);
+        is_active_.assign(n_, false);
+
+        for (int node = 0; node < n_; ++node) {
+            // flow straight from source to sink through node
+            max_flow_ += std::min(source_cap_[node], sink_cap_[node]);
+            terminal_[node] = source_cap_[node] - sink_cap_[node];
+
+            if (terminal_[node] != 0) {
+                tree_[node] = (terminal_[node] > 0) ? SOURCE_TREE : SINK_TREE;
+                parent_[node] = TERMINAL;
+                dist_[node] = 1;
+                activate(node);
+            }
+        }
+
+        while (true) {
+            auto [s_end, d] = grow();
+            if (s_end == -1)
+                break;
+
+            ++time_;
+            augment(s_end, d);
+
+            while (orphans_.empty() == false) {
+                int orphan = orphans_.back();
+                orphans_.pop_back();
+                adopt(orphan);
+            }
+        }
+    }
+
+public:
+    BoykovKolmogorovSolver(int width, int height, int connectivity = 4) :
+        width_(width), height_(height), n_(width * height) {
+        if (connectivity != 4 && connectivity != 8)
+            throw std::invalid_argument("connectivity must be 4 or 8");
+        num_dirs_ = connectivity;
+        capacity_.assign(num_dirs_, std::vector<long>(n_, 0));
+        source_cap_.assign(n_, 0);
+        sink_cap_.assign(n_, 0);
+    }
+
+    int node(int x, int y) const {
+        return y * width_ + x;
+    }
+
+    void setTerminalCapacities(int x, int y, long source_cap, long sink_cap) {
+        source_cap_[node(x, y)] = source_cap;
+        sink_cap_[node(x, y)] = sink_cap;
+    }
+
+    // capacity from (x, y) to its neighbour in direction d, see DX / DY.
+    // edges leaving the grid are ignored
+    void setNeighbourCapacity(int x, int y, int d, long capacity) {
+        if (neighbour(node(x, y), d) != -1)
+            capacity_[d][node(x, y)] = capacity;
+    }
+
+    long getMaxFlow() {
+        if (solved_ == false) {
+            solved_ = true;
+            solve();
+        }
+        return max_flow_;
+    }
+
+    // segmentation label: whether (x, y) ends up on the source side of the minimum cut
+    bool isSourceSide(int x, int y) {
+        getMaxFlow();
+        return tree_[node(x, y)] == SOURCE_TREE;
+    }
+
+};
+
+
+void testSmallSegmentation() {
+    // pixel intensities, the bright blob should be separated from the background
+    std::vector<std::vector<int>> image = {
+        {1, 1, 1, 1, 1},
+        {1, 9, 8, 1, 1},
+        {1, 8, 9, 9, 1},
+        {1, 1, 9, 1, 1},
+        {1, 1, 1, 1, 1}
+    };
+    int width = 5, height = 5;
+
+    BoykovKolmogorovSolver solver(width, height, 4);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            // data term: bright pixels like the source, dark ones the sink
+            solver.setTerminalCapacities(x, y, image[y][x], 10 - image[y][x]);
+
+            // smoothness term: cutting between similar pixels is expensive
+            for (int d = 0; d < 4; ++d) {
+                int nx = x + (d == 0) - (d == 1), ny = y + (d == 2) - (d == 3);
+                if (nx >= 0 && nx < width && ny >= 0 && ny < height)
+                    solver.setNeighbourCapacity(x, y, d, 3 - std::min(3, std::abs(image[y][x] - image[ny][nx])));
+            }
+        }
+    }
+
+    // Maximum flow is: 27
+    std::cout << "Maximum flow is: " << solver.getMaxFlow() << std::endl;
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x)
+            std::cout << (solver.isSourceSide(x, y) ? '#' : '.');
+        std::cout << std::endl;
+    }
+}
+
+
+
+int main() {
+    testSmallSegmentation();
+
+    return 0;
+}
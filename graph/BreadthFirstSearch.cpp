@@ -3,6 +3,10 @@
 #include <exception>
 #include <queue>
 #include <algorithm>
+#include <string>
+#include <stdexcept>
+#include <cstdint>
+#include <math.h>
 
 struct Edge {
     int from, to, cost;
@@ -10,46 +14,140 @@ struct Edge {
 
 using Graph = std::vector<std::vector<Edge>>;
 
+// adjacency list seen through the same numNodes / forEachEdge interface as GridGraph
+class AdjacencyListGraph {
+private:
+    // borrowed, must outlive the solver
+    const Graph* graph_;
+
+public:
+    AdjacencyListGraph(const Graph& graph) : graph_(&graph) {}
+
+    int numNodes() const {
+        return graph_->size();
+    }
+
+    template <typename F>
+    void forEachEdge(int node, F f) const {
+        const auto& edges = (*graph_)[node];
+        for (size_t i = 0; i < edges.size(); ++i)
+            f(i, edges[i].to, edges[i].cost);
+    }
+};
+
+// implicit 4 or 8 connected grid over a dense row major cost raster (see graph/Dijkstra.cpp),
+// nothing is stored per edge. negative or infinite cells are blocked, bfs ignores the costs
+class GridGraph {
+public:
+    // direction d and d ^ 1 are opposite, the first four are axis aligned
+    static constexpr int DX[8] = {1, -1, 0, 0, 1, -1, 1, -1};
+    static constexpr int DY[8] = {0, 0, 1, -1, 1, -1, -1, 1};
+
+private:
+    int width_, height_, connectivity_;
+
+    // borrowed, must outlive the graph
+    const std::vector<float>* cost_;
+
+public:
+    GridGraph(int width, int height, const std::vector<float>& cost, int connectivity = 8) :
+        width_(width), height_(height), connectivity_(connectivity), cost_(&cost) {
+        if (connectivity != 4 && connectivity != 8)
+            throw std::invalid_argument("connectivity must be 4 or 8");
+        if ((long)cost.size() != (long)width * height)
+            throw std::invalid_argument("raster size doesn't match the grid");
+    }
+
+    int numNodes() const {
+        return width_ * height_;
+    }
+
+    int node(int x, int y) const {
+        return y * width_ + x;
+    }
+
+    bool passable(int node) const {
+        return (*cost_)[node] >= 0 && std::isfinite((*cost_)[node]);
+    }
+
+    // false outside the grid
+    bool passable(int x, int y) const {
+        return x >= 0 && x < width_ && y >= 0 && y < height_ && passable(node(x, y));
+    }
+
+    // edge ids are node * 8 + direction, diagonal steps can't cut a blocked corner
+    template <typename F>
+    void forEachEdge(int node, F f) const {
+        const int x = node % width_, y = node / width_;
+        for (int d = 0; d < connectivity_; ++d) {
+            int nx = x + DX[d], ny = y + DY[d];
+            if (passable(nx, ny) == false)
+                continue;
+            if (d >= 4 && (passable(nx, y) == false || passable(x, ny) == false))
+                continue;
+            f(node * 8 + d, ny * width_ + nx, (*cost_)[ny * width_ + nx]);
+        }
+    }
+};
+
+// one bit per node, an 8 times smaller visited set than a byte array on huge grids
+class BitArray {
+private:
+    std::vector<uint64_t> words_;
+
+public:
+    void reset(int n) {
+        words_.assign((n + 63) / 64, 0);
+    }
+
+    bool test(int i) const {
+        return (words_[i >> 6] >> (i & 63)) & 1;
+    }
+
+    void set(int i) {
+        words_[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+};
+
+// runs on any graph type with numNodes() and forEachEdge(node, f), the graph is copied by value
+// so implicit graphs like GridGraph stay cheap and adjacency lists are only referenced
+template <typename GraphType = AdjacencyListGraph>
 class BreadthFirstSearchSolver {
 private:
     int n_;
     std::vector<int> prev_; 
-    Graph graph_;
+    GraphType graph_;
+    BitArray visited_;
 
     void breadthFirstSearch(int start) {
-        std::vector<bool> visited(n_, false);
         std::queue<int> q;
-        prev_ = std::vector<int>(n_, -1);
-
-        // std::cout << "n " << n_ << std::endl;
-        // std::cout << "start " << start << std::endl;
+        visited_.reset(n_);
+        prev_.assign(n_, -1);
 
         q.push(start);
-        visited[start] = true;
+        visited_.set(start);
 
 
         while (q.empty() == false) {
             int curr = q.front();
             q.pop();
 
-            for (const Edge& edge : graph_[curr]) {
-                if (visited[edge.to] == false) {
-                    q.push(edge.to);
-                    prev_[edge.to] = curr;
-                    visited[edge.to] = true;
+            graph_.forEachEdge(curr, [&](int, int to, double) {
+                if (visited_.test(to) == false) {
+                    q.push(to);
+                    prev_[to] = curr;
+                    visited_.set(to);
                 }
-            }
+            });
         }
     }
 
 
 public:
-    BreadthFirstSearchSolver(Graph& graph) {
-        if (graph.empty())
+    BreadthFirstSearchSolver(const GraphType& graph) : graph_(graph) {
+        n_ = graph.numNodes();
+        if (n_ == 0)
             throw std::invalid_argument("graph cannot be empty");
-        graph_ = graph;
-        n_ = graph.size();
-
     }
 
     std::vector<int> reconstructPath(int start, int end) {
@@ -68,6 +166,8 @@ public:
     }
 };
 
+BreadthFirstSearchSolver(const Graph&) -> BreadthFirstSearchSolver<AdjacencyListGraph>;
+
 void addUndirectedEdge(Graph& graph, int from, int to, int cost=0) {
     graph[from].push_back({from, to, cost});
     graph[to].push_back({to, from, cost});
@@ -105,6 +205,31 @@ int main() {
         std::cout << p << " ";
     std::cout << std::endl;
 
+    // occupancy grid, # is blocked
+    std::vector<std::string> map = {
+        "......",
+        ".####.",
+        "....#.",
+        "###.#.",
+        "......",
+    };
+    int width = map[0].size(), height = map.size();
+    std::vector<float> raster;
+    for (const auto& row : map) {
+        for (char cell : row)
+            raster.push_back(cell == '#' ? -1 : 1);
+    }
+
+    GridGraph grid(width, height, raster, 4);
+    BreadthFirstSearchSolver grid_solver(grid);
+    auto grid_path = grid_solver.reconstructPath(grid.node(0, 4), grid.node(0, 2));
+
+    // The shortest path takes 8 steps around the walls
+    for (int node : grid_path)
+        map[node / width][node % width] = '*';
+    for (const auto& row : map)
+        std::cout << row << std::endl;
+
 
     return 0;
 }
\ No newline at end of file
@@ -1,38 +1,20 @@
 #include <vector>
 #include <iostream>
-#include <memory>
 #include <limits>
 #include <algorithm>
-#include <queue>
-#include <math.h>
+#include <string>
+#include <stdexcept>
 
 struct Edge {
     int from, to;
-    std::weak_ptr<Edge> residual;
     long flow;
     long capacity;
 
-    Edge(int from, int to, long capacity) {
-        this->from = from;
-        this->to = to;
-        this->capacity = capacity;
-    }
-
-    bool isResidual() {
+    bool isResidual() const {
         return capacity == 0;
     }
-    
-    long remainingCapacity() {
-        return capacity - flow;
-    }
-
-    void augment(long bottle_neck) {
-        flow += bottle_neck;
-        auto res_ptr = residual.lock();
-        res_ptr->flow -= bottle_neck;
-    }
 
-    std::string toString(int src, int sink) {
+    std::string toString(int src, int sink) const {
         std::string u = (from == src) ? "s" : ((from == sink) ? "t" : std::to_string(from));
         std::string v = (to == src) ? "s" : ((to == sink) ? "t" : std::to_string(to));
         std::string res = "Edge " + u + " -> " + v  +
@@ -44,7 +26,13 @@ struct Edge {
 
 };
 
-using Graph = std::vector<std::vector<std::shared_ptr<Edge> > >;
+using Graph = std::vector<std::vector<Edge> >;
+
+// a src -> sink path given as edge ids, carrying flow
+struct FlowPath {
+    long flow;
+    std::vector<int> edges;
+};
 
 
 class NetworkFlowSolverBase {
@@ -53,44 +41,196 @@ protected:
 
     bool solved_ = false;
 
-    Graph graph_;
+    // flat edge arrays, an edge e and its residual edge are always stored at e and e^1
+    std::vector<int> from_, to_;
+    std::vector<long> flow_, capacity_;
+
+    // csr adjacency, edges leaving node are adj_[offsets_[node]] ... adj_[offsets_[node + 1] - 1]
+    std::vector<int> offsets_, adj_;
+    bool adjacency_built_ = false;
 
     int visited_token_ = 1;
     std::vector<int> visited_;
 
     long max_flow_ = 0;
 
+    std::vector<bool> min_cut_;
+    bool min_cut_built_ = false;
+
     void execute() {
         if (solved_)
             return;
         solved_ = true;
+        min_cut_built_ = false;
+        buildAdjacency();
         solve();
     }
 
+    // counting sort of edge ids by their from node, keeps insertion order within a node
+    void buildAdjacency() {
+        if (adjacency_built_)
+            return;
+        adjacency_built_ = true;
+
+        const int num_edges = from_.size();
+        offsets_.assign(num_nodes_ + 1, 0);
+        for (int e = 0; e < num_edges; ++e)
+            ++offsets_[from_[e] + 1];
+        for (int node = 0; node < num_nodes_; ++node)
+            offsets_[node + 1] += offsets_[node];
+
+        std::vector<int> pos(offsets_.begin(), offsets_.end() - 1);
+        adj_.resize(num_edges);
+        for (int e = 0; e < num_edges; ++e)
+            adj_[pos[from_[e]]++] = e;
+    }
+
+    long remainingCapacity(int e) const {
+        return capacity_[e] - flow_[e];
+    }
+
+    void augment(int e, long bottle_neck) {
+        flow_[e] += bottle_neck;
+        flow_[e ^ 1] -= bottle_neck;
+    }
+
+    // scratch space for repairing the flow after a capacity decrease
+    std::vector<int> repair_prev_, repair_queue_;
+
+    // bfs over residual edges from start until isTarget accepts a node, then pushes up to limit
+    // along that path. with backwards set the path ends at start instead of beginning there.
+    // only touches the nodes the bfs reaches and returns how much was pushed
+    template <typename Target>
+    long pushAlongResidualPath(int start, long limit, bool backwards, Target isTarget) {
+        ++visited_token_;
+        visited_[start] = visited_token_;
+        repair_queue_.clear();
+        repair_queue_.push_back(start);
+
+        int found = -1;
+        for (size_t head = 0; head < repair_queue_.size() && found == -1; ++head) {
+            int node = repair_queue_[head];
+            for (int i = offsets_[node]; i < offsets_[node + 1]; ++i) {
+                // going backwards, node -> to is edge e so to -> node is e^1
+                const int e = backwards ? adj_[i] ^ 1 : adj_[i];
+                const int next = backwards ? from_[e] : to_[e];
+                if (remainingCapacity(e) <= 0 || visited_[next] == visited_token_)
+                    continue;
+
+                visited_[next] = visited_token_;
+                repair_prev_[next] = e;
+                if (isTarget(next)) {
+                    found = next;
+                    break;
+                }
+                repair_queue_.push_back(next);
+            }
+        }
+        ++visited_token_;
+
+        if (found == -1)
+            return 0;
+
+        auto step = [&](int node) { return backwards ? to_[repair_prev_[node]] : from_[repair_prev_[node]]; };
+        long bottle_neck = limit;
+        for (int node = found; node != start; node = step(node))
+            bottle_neck = std::min(bottle_neck, remainingCapacity(repair_prev_[node]));
+        for (int node = found; node != start; node = step(node))
+            augment(repair_prev_[node], bottle_neck);
+
+        return bottle_neck;
+    }
+
+    // lowering the flow on edge left a surplus at its from node and a deficit at its to node.
+    // first try to reroute the surplus around the edge, anything left over is sent back
+    // to a terminal from the surplus node and pulled from a terminal into the deficit node
+    void cancelExcess(int edge, long excess) {
+        const int u = from_[edge], v = to_[edge];
+        auto isTerminal = [&](int node) { return node == src_node_ || node == sink_node_; };
+
+        long rerouted = 0;
+        while (rerouted < excess) {
+            long pushed = pushAlongResidualPath(u, excess - rerouted, false, [&](int node) { return node == v; });
+            if (pushed == 0)
+                break;
+            rerouted += pushed;
+        }
+
+        for (long surplus = isTerminal(u) ? 0 : excess - rerouted; surplus > 0; )
+            surplus -= pushAlongResidualPath(u, surplus, false, isTerminal);
+        for (long deficit = isTerminal(v) ? 0 : excess - rerouted; deficit > 0; )
+            deficit -= pushAlongResidualPath(v, deficit, true, isTerminal);
+
+        // net flow out of the source
+        max_flow_ = 0;
+        for (int i = offsets_[src_node_]; i < offsets_[src_node_ + 1]; ++i)
+            max_flow_ += flow_[adj_[i]];
+    }
+
 
 public:
     NetworkFlowSolverBase(int num_nodes, int src_node, int sink_node) :
         num_nodes_(num_nodes), src_node_(src_node), sink_node_(sink_node) {
-            graph_.resize(num_nodes);
             visited_.resize(num_nodes);
+            repair_prev_.resize(num_nodes);
     }
 
     Graph getGraph() {
         execute();
-        return graph_;
+        Graph graph(num_nodes_);
+        for (int e : adj_)
+            graph[from_[e]].push_back({from_[e], to_[e], flow_[e], capacity_[e]});
+        return graph;
     }
 
-    virtual void addEdge(int from, int to, long capacity) {
-        if (capacity <= 0) 
-            return;
+    // returns the id of the new edge. zero capacity edges are kept so setCapacity
+    // can open them later
+    int addEdge(int from, int to, long capacity) {
+        if (capacity < 0)
+            throw std::invalid_argument("capacity must be non-negative");
+
+        from_.push_back(from);
+        to_.push_back(to);
+        flow_.push_back(0);
+        capacity_.push_back(capacity);
+
+        from_.push_back(to);
+        to_.push_back(from);
+        flow_.push_back(0);
+        capacity_.push_back(0);
+
+        adjacency_built_ = false;
+        solved_ = false;
+        return from_.size() - 2;
+    }
 
-        auto e1 = std::make_shared<Edge>(from, to, capacity);
-        auto e2 = std::make_shared<Edge>(to, from, 0);
-        e1->residual = e2;
-        e2->residual = e1;
+    // start over on the same network with new terminals, edges and capacities are kept
+    void reset(int src_node, int sink_node) {
+        src_node_ = src_node;
+        sink_node_ = sink_node;
+        std::fill(flow_.begin(), flow_.end(), 0);
+        max_flow_ = 0;
+        solved_ = false;
+    }
+
+    // edge is an id returned by addEdge. the next getMaxFlow() re-optimizes from
+    // the current flow rather than starting over
+    void setCapacity(int edge, long capacity) {
+        if (edge < 0 || edge >= (int)from_.size() || edge % 2 != 0)
+            throw std::invalid_argument("not a forward edge id");
+        if (capacity < 0)
+            throw std::invalid_argument("capacity must be non-negative");
+
+        buildAdjacency();
+        capacity_[edge] = capacity;
+
+        long excess = flow_[edge] - capacity;
+        if (excess > 0) {
+            augment(edge, -excess);
+            cancelExcess(edge, excess);
+        }
 
-        graph_[from].push_back(e1);
-        graph_[to].push_back(e2);
+        solved_ = false;
     }
 
     long getMaxFlow() {
@@ -98,6 +238,123 @@ public:
         return max_flow_;
     }
 
+    // zero copy accessors, edge ids come from addEdge (forward edges are even,
+    // e ^ 1 is the residual edge of e) and stay valid for the lifetime of the solver
+    int getNumEdges() const {
+        return from_.size();
+    }
+
+    int getFrom(int edge) const {
+        return from_[edge];
+    }
+
+    int getTo(int edge) const {
+        return to_[edge];
+    }
+
+    long getCapacity(int edge) const {
+        return capacity_[edge];
+    }
+
+    long getFlow(int edge) {
+        execute();
+        return flow_[edge];
+    }
+
+    // true for the nodes on the source side of a minimum cut, i.e. the nodes
+    // still reachable from the source in the residual graph
+    const std::vector<bool>& getMinCut() {
+        execute();
+        if (min_cut_built_)
+            return min_cut_;
+        min_cut_built_ = true;
+
+        min_cut_.assign(num_nodes_, false);
+        min_cut_[src_node_] = true;
+        std::vector<int> stack = {src_node_};
+        while (stack.empty() == false) {
+            int node = stack.back();
+            stack.pop_back();
+            for (int i = offsets_[node]; i < offsets_[node + 1]; ++i) {
+                const int e = adj_[i];
+                if (remainingCapacity(e) > 0 && min_cut_[to_[e]] == false) {
+                    min_cut_[to_[e]] = true;
+                    stack.push_back(to_[e]);
+                }
+            }
+        }
+
+        return min_cut_;
+    }
+
+    // splits the flow into at most getNumEdges() / 2 weighted src -> sink paths,
+    // flow going around cycles is dropped since it doesn't reach the sink
+    std::vector<FlowPath> getFlowPaths() {
+        execute();
+
+        std::vector<long> remaining(from_.size(), 0);
+        for (int e = 0; e < (int)from_.size(); e += 2)
+            remaining[e] = std::max(0L, flow_[e]);
+
+        std::vector<int> next(offsets_.begin(), offsets_.end() - 1);
+        // position of each node on the current walk, -1 if it's not on it
+        std::vector<int> on_walk(num_nodes_, -1);
+
+        std::vector<FlowPath> paths;
+        std::vector<int> walk;
+        while (true) {
+            int at = src_node_;
+            on_walk[at] = 0;
+            while (at != sink_node_) {
+                while (next[at] < offsets_[at + 1] && remaining[adj_[next[at]]] == 0)
+                    ++next[at];
+                if (next[at] == offsets_[at + 1])
+                    break;
+
+                const int e = adj_[next[at]];
+                if (on_walk[to_[e]] == -1) {
+                    walk.push_back(e);
+                    at = to_[e];
+                    on_walk[at] = walk.size();
+                    continue;
+                }
+
+                // closed a cycle, cancel it and resume from where it started
+                long cycle_flow = remaining[e];
+                for (int i = on_walk[to_[e]]; i < (int)walk.size(); ++i)
+                    cycle_flow = std::min(cycle_flow, remaining[walk[i]]);
+                remaining[e] -= cycle_flow;
+                for (int i = on_walk[to_[e]]; i < (int)walk.size(); ++i)
+                    remaining[walk[i]] -= cycle_flow;
+
+                while ((int)walk.size() > on_walk[to_[e]]) {
+                    on_walk[to_[walk.back()]] = -1;
+                    walk.pop_back();
+                }
+                at = to_[e];
+            }
+
+            for (int e : walk)
+                on_walk[to_[e]] = -1;
+            on_walk[src_node_] = -1;
+
+            // no more flow leaves the source
+            if (at != sink_node_)
+                break;
+
+            long path_flow = std::numeric_limits<long>::max();
+            for (int e : walk)
+                path_flow = std::min(path_flow, remaining[e]);
+            for (int e : walk)
+                remaining[e] -= path_flow;
+
+            paths.push_back({path_flow, walk});
+            walk.clear();
+        }
+
+        return paths;
+    }
+
     virtual void solve() = 0;
 
     void visit(int i) {
@@ -119,59 +376,113 @@ public:
 class CapacityScalingSolver : public NetworkFlowSolverBase {
 private:
     long delta_ = 0;
-    
-    long dfs(int node, long flow) {
-        if (node == sink_node_)
-            return flow;
 
-        visit(node);
+    // dinic style level graph and current arcs, restricted to edges with residual >= delta_
+    std::vector<int> level_, next_;
+    std::vector<int> queue_, path_;
+
+    // largest power of 2 <= x, by clearing the lowest set bit until one is left
+    static long highestPowerOfTwo(long x) {
+        while (x & (x - 1))
+            x &= x - 1;
+        return x;
+    }
+
+    bool constructLevelGraph() {
+        level_.assign(num_nodes_, -1);
+        level_[src_node_] = 0;
+
+        queue_.clear();
+        queue_.push_back(src_node_);
 
-        auto& edges = graph_[node];
-        for (auto edge_ptr : edges) {
-            long remaining_cap = edge_ptr->remainingCapacity();
-            if (remaining_cap >= delta_ && visited(edge_ptr->to) == false) {
-                long bottle_neck = dfs(edge_ptr->to, std::min(flow, remaining_cap));
+        for (size_t head = 0; head < queue_.size(); ++head) {
+            int node = queue_[head];
 
-                if (bottle_neck > 0) {
-                    edge_ptr->augment(bottle_neck);
-                    return bottle_neck;
+            for (int i = offsets_[node]; i < offsets_[node + 1]; ++i) {
+                const int e = adj_[i];
+                if (remainingCapacity(e) >= delta_ && level_[to_[e]] == -1) {
+                    level_[to_[e]] = level_[node] + 1;
+                    queue_.push_back(to_[e]);
                 }
-                
             }
         }
-        
-        return 0;
+
+        return level_[sink_node_] != -1;
+    }
+
+    // iterative multi path dfs over the delta level graph, see DinicSolver::blockingFlow
+    long blockingFlow() {
+        long total_flow = 0;
+
+        path_.clear();
+        int at = src_node_;
+        while (true) {
+            if (at == sink_node_) {
+                // find bottle neck value and the first edge it takes below delta_
+                long bottle_neck = std::numeric_limits<long>::max();
+                for (int e : path_)
+                    bottle_neck = std::min(bottle_neck, remainingCapacity(e));
+
+                int below_delta = path_.size();
+                for (int i = 0; i < (int)path_.size(); ++i) {
+                    augment(path_[i], bottle_neck);
+                    if (remainingCapacity(path_[i]) < delta_ && below_delta == (int)path_.size())
+                        below_delta = i;
+                }
+                total_flow += bottle_neck;
+
+                path_.resize(below_delta);
+                at = path_.empty() ? src_node_ : to_[path_.back()];
+                continue;
+            }
+
+            // advance along the current arc
+            for (; next_[at] < offsets_[at + 1]; next_[at]++) {
+                const int e = adj_[next_[at]];
+                if (remainingCapacity(e) >= delta_ && level_[to_[e]] == level_[at] + 1)
+                    break;
+            }
+
+            if (next_[at] < offsets_[at + 1]) {
+                const int e = adj_[next_[at]];
+                path_.push_back(e);
+                at = to_[e];
+                continue;
+            }
+
+            // dead end, retreat one edge and never try that edge again this phase
+            if (at == src_node_)
+                break;
+            path_.pop_back();
+            at = path_.empty() ? src_node_ : to_[path_.back()];
+            next_[at]++;
+        }
+
+        return total_flow;
     }
 
 public:
 
     CapacityScalingSolver(int num_nodes, int src_node, int sink_node) :
-        NetworkFlowSolverBase(num_nodes, src_node, sink_node) {}
+        NetworkFlowSolverBase(num_nodes, src_node, sink_node) {
+        level_.resize(num_nodes_);
+        next_.resize(num_nodes_);
+        queue_.reserve(num_nodes_);
+    }
     
     void solve() override {
-        // largest power of 2 < largest capacity
-        // delta_ = (long) std::pow(2, (int)std::floor(std::log(delta_)/std::log(2)));
-        long n = 1;
-        while (std::pow(2, n) < delta_)
-            ++n;
-        delta_ = std::pow(2, --n);
-
-
-        // repeatedly find aug path from s->t
-        static constexpr long INF = std::numeric_limits<long>::max() / 2;
-        for (long flow = 0; delta_ > 0; delta_ = delta_/2) {
-            do {
-                markAllNodesAsUnvisited();
-                flow = dfs(src_node_, INF);
-                max_flow_ += flow;
-            } while (flow != 0);
+        // capacities may have changed since the last solve
+        long max_capacity = 0;
+        for (long capacity : capacity_)
+            max_capacity = std::max(max_capacity, capacity);
+
+        // every delta phase runs dinic on the edges with at least delta_ residual capacity
+        for (delta_ = highestPowerOfTwo(max_capacity); delta_ > 0; delta_ /= 2) {
+            while (constructLevelGraph()) {
+                next_.assign(offsets_.begin(), offsets_.end() - 1);
+                max_flow_ += blockingFlow();
+            }
         }
-
-    }
-
-    void addEdge(int from, int to, long capacity) override {
-        NetworkFlowSolverBase::addEdge(from, to, capacity);
-        delta_ = std::max(delta_, capacity);
     }
 
 };
@@ -0,0 +1,597 @@
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <limits>
+#include <math.h>
+#include <algorithm>
+#include <stdexcept>
+#include <sstream>
+#include <random>
+#include <chrono>
+#include <array>
+
+struct Edge {
+    double cost;
+    int from, to;
+};
+using Graph = std::vector<std::vector<Edge>>;
+
+constexpr double POS_INF = std::numeric_limits<double>::infinity();
+
+struct Node {
+    int id;
+    double value;
+};
+
+// contraction hierarchies. nodes are contracted one at a time in order of importance and
+// shortcuts are added so distances between the remaining nodes don't change. a query then
+// only has to walk upwards in the order from both ends, which touches a tiny part of the graph
+class ContractionHierarchy {
+private:
+    // arc of the hierarchy, middle is the contracted node a shortcut skips or -1 for an original edge
+    struct Arc {
+        int node;
+        double cost;
+        int middle;
+    };
+
+    // flat adjacency of the final hierarchy, the arcs of node are [offsets[node], offsets[node + 1])
+    struct SearchGraph {
+        std::vector<int> offsets;
+        std::vector<int> targets;
+        std::vector<double> costs;
+        std::vector<int> middles;
+    };
+
+    // per search state, lazily reset by epoch like DijkstraWorkspace
+    struct SearchSpace {
+        unsigned epoch = 0;
+        std::vector<unsigned> stamp;
+        std::vector<double> dist;
+        std::vector<int> prev, middle;
+        std::vector<Node> heap;
+
+        void resize(int n) {
+            stamp.assign(n, 0);
+            dist.resize(n);
+            prev.resize(n);
+            middle.resize(n);
+        }
+
+        void newQuery() {
+            heap.clear();
+            if (++epoch == 0) {
+                std::fill(stamp.begin(), stamp.end(), 0);
+                epoch = 1;
+            }
+        }
+
+        double get(int node) const {
+            return (stamp[node] == epoch) ? dist[node] : POS_INF;
+        }
+
+        void update(int node, double d, int p, int m) {
+            stamp[node] = epoch;
+            dist[node] = d;
+            prev[node] = p;
+            middle[node] = m;
+        }
+    };
+
+    static constexpr unsigned MAGIC = 0x43484931; // "CHI1"
+
+    // witness searches give up after settling this many nodes and assume no witness exists,
+    // which only costs an unnecessary shortcut
+    static constexpr int MAX_SETTLED = 500;
+
+    int n_ = 0;
+    std::vector<int> rank_;
+
+    // up_[node] holds node -> higher ranked nodes, down_[node] holds higher ranked nodes -> node
+    // stored reversed, so the backward search also only climbs
+    SearchGraph up_, down_;
+
+    SearchSpace forward_, backward_;
+
+    static bool heapCmp(const Node& a, const Node& b) {
+        return a.value > b.value;
+    }
+
+    static SearchGraph toSearchGraph(const std::vector<std::vector<Arc>>& arcs) {
+        SearchGraph graph;
+        graph.offsets.push_back(0);
+        for (const auto& list : arcs) {
+            for (const Arc& arc : list) {
+                graph.targets.push_back(arc.node);
+                graph.costs.push_back(arc.cost);
+                graph.middles.push_back(arc.middle);
+            }
+            graph.offsets.push_back(graph.targets.size());
+        }
+        return graph;
+    }
+
+    // state used only while contracting
+    class Builder {
+    private:
+        int n_;
+
+        // arcs between nodes that are not contracted yet
+        std::vector<std::vector<Arc>> out_, in_;
+
+        // arcs with at least one contracted end, by their tail
+        std::vector<std::vector<Arc>> hierarchy_;
+
+        std::vector<bool> contracted_;
+        std::vector<int> contracted_neighbours_;
+        SearchSpace witness_;
+
+        // targets of the current witness search are stamped with target_epoch_
+        std::vector<unsigned> target_;
+        unsigned target_epoch_ = 0;
+
+        // (from, to, cost, middle), collected first since adding them changes in_ and out_
+        struct Shortcut {
+            int from, to;
+            double cost;
+            int middle;
+        };
+        std::vector<Shortcut> shortcuts_;
+
+        // dijkstra from source over the remaining graph avoiding skip. stops past limit or
+        // once every node marked as a target this query has been settled
+        void witnessSearch(int source, int skip, double limit, int targets) {
+            witness_.newQuery();
+            witness_.update(source, 0, -1, -1);
+            auto& pq = witness_.heap;
+            pq.push_back({source, 0});
+
+            int settled = 0;
+            while (pq.empty() == false && targets > 0) {
+                std::pop_heap(pq.begin(), pq.end(), heapCmp);
+                auto [id, value] = pq.back();
+                pq.pop_back();
+                if (witness_.get(id) < value)
+                    continue;
+                if (value > limit || ++settled > MAX_SETTLED)
+                    break;
+                if (target_[id] == target_epoch_)
+                    --targets;
+
+                for (const Arc& arc : out_[id]) {
+                    if (arc.node == skip)
+                        continue;
+                    double new_dist = value + arc.cost;
+                    if (new_dist < witness_.get(arc.node)) {
+                        witness_.update(arc.node, new_dist, id, -1);
+                        pq.push_back({arc.node, new_dist});
+                        std::push_heap(pq.begin(), pq.end(), heapCmp);
+                    }
+                }
+            }
+        }
+
+        // shortcuts u -> w needed to contract node, or only their number when add is false
+        int contract(int node, bool add) {
+            int shortcuts = 0;
+            for (const Arc& in : in_[node]) {
+                double limit = 0;
+                int targets = 0;
+                ++target_epoch_;
+                for (const Arc& out : out_[node]) {
+                    if (out.node != in.node) {
+                        limit = std::max(limit, in.cost + out.cost);
+                        target_[out.node] = target_epoch_;
+                        ++targets;
+                    }
+                }
+                witnessSearch(in.node, node, limit, targets);
+
+                for (const Arc& out : out_[node]) {
+                    if (out.node == in.node)
+                        continue;
+                    double via = in.cost + out.cost;
+                    if (witness_.get(out.node) <= via)
+                        continue;
+
+                    ++shortcuts;
+                    if (add)
+                        shortcuts_.push_back({in.node, out.node, via, node});
+                }
+            }
+            return shortcuts;
+        }
+
+        // edge difference plus the number of contracted neighbours, which spreads contraction
+        // evenly over the graph instead of eating one region first
+        int priority(int node) {
+            int removed = out_[node].size() + in_[node].size();
+            return contract(node, false) - removed + contracted_neighbours_[node];
+        }
+
+        // moves the arcs of node into the finished hierarchy and out of the remaining graph
+        void remove(int node) {
+            for (const Arc& out : out_[node]) {
+                hierarchy_[node].push_back(out);
+                auto& list = in_[out.node];
+                list.erase(std::find_if(list.begin(), list.end(), [&](const Arc& a) { return a.node == node; }));
+                ++contracted_neighbours_[out.node];
+            }
+            for (const Arc& in : in_[node]) {
+                hierarchy_[in.node].push_back({node, in.cost, in.middle});
+                auto& list = out_[in.node];
+                list.erase(std::find_if(list.begin(), list.end(), [&](const Arc& a) { return a.node == node; }));
+                ++contracted_neighbours_[in.node];
+            }
+            out_[node].clear();
+            in_[node].clear();
+        }
+
+    public:
+        Builder(const Graph& graph) : n_(graph.size()), out_(n_), in_(n_), hierarchy_(n_),
+            contracted_(n_, false), contracted_neighbours_(n_, 0), target_(n_, 0) {
+            witness_.resize(n_);
+            for (const auto& edges : graph) {
+                for (auto [cost, from, to] : edges) {
+                    if (cost < 0)
+                        throw std::invalid_argument("contraction hierarchies need non negative costs");
+                    if (from != to)
+                        addArc(from, to, cost, -1);
+                }
+            }
+        }
+
+        // keeps a single arc per node pair, the cheaper one
+        void addArc(int from, int to, double cost, int middle) {
+            for (Arc& arc : out_[from]) {
+                if (arc.node == to) {
+                    if (cost < arc.cost) {
+                        arc = {to, cost, middle};
+                        for (Arc& rev : in_[to]) {
+                            if (rev.node == from)
+                                rev = {from, cost, middle};
+                        }
+                    }
+                    return;
+                }
+            }
+            out_[from].push_back({to, cost, middle});
+            in_[to].push_back({from, cost, middle});
+        }
+
+        // contracts everything, least important node first. priorities only go stale
+        // around contracted nodes, so they are recomputed lazily when popped
+        std::vector<int> order() {
+            using Entry = std::pair<int, int>; // priority, node
+            std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pq;
+            for (int node = 0; node < n_; ++node)
+                pq.push({priority(node), node});
+
+            std::vector<int> rank(n_);
+            for (int next = 0; pq.empty() == false; ) {
+                int node = pq.top().second;
+                pq.pop();
+                if (contracted_[node])
+                    continue;
+
+                int p = priority(node);
+                if (pq.empty() == false && p > pq.top().first) {
+                    pq.push({p, node});
+                    continue;
+                }
+
+                shortcuts_.clear();
+                contract(node, true);
+                remove(node);
+                for (auto [from, to, cost, middle] : shortcuts_)
+                    addArc(from, to, cost, middle);
+                contracted_[node] = true;
+                rank[node] = next++;
+            }
+            return rank;
+        }
+
+        const std::vector<std::vector<Arc>>& arcs() const {
+            return hierarchy_;
+        }
+    };
+
+    void finish() {
+        forward_.resize(n_);
+        backward_.resize(n_);
+    }
+
+    // settles the closest node on one side, stopping at nodes whose key can't beat mu
+    void step(const SearchGraph& graph, SearchSpace& ws, const SearchSpace& other, double& mu, int& meet) const {
+        auto& pq = ws.heap;
+        std::pop_heap(pq.begin(), pq.end(), heapCmp);
+        auto [id, value] = pq.back();
+        pq.pop_back();
+        if (ws.get(id) < value)
+            return;
+
+        if (value + other.get(id) < mu) {
+            mu = value + other.get(id);
+            meet = id;
+        }
+
+        for (int i = graph.offsets[id]; i < graph.offsets[id + 1]; ++i) {
+            int to = graph.targets[i];
+            double new_dist = value + graph.costs[i];
+            if (new_dist < ws.get(to)) {
+                ws.update(to, new_dist, id, graph.middles[i]);
+                pq.push_back({to, new_dist});
+                std::push_heap(pq.begin(), pq.end(), heapCmp);
+            }
+        }
+    }
+
+    // middle node of the arc from -> to, found in the lists of whichever end ranks lower
+    int findMiddle(int from, int to) const {
+        const SearchGraph& graph = (rank_[from] < rank_[to]) ? up_ : down_;
+        int at = (rank_[from] < rank_[to]) ? from : to;
+        int target = (rank_[from] < rank_[to]) ? to : from;
+        for (int i = graph.offsets[at]; i < graph.offsets[at + 1]; ++i) {
+            if (graph.targets[i] == target)
+                return graph.middles[i];
+        }
+        throw std::logic_error("arc missing from the hierarchy");
+    }
+
+    // appends the original nodes of arc from -> to after from, recursing through shortcuts
+    void unpack(int from, int to, int middle, std::vector<int>& path) const {
+        // (from, to, middle) triples, the top of the stack is the next arc along the path
+        std::vector<std::array<int, 3>> stack = {{from, to, middle}};
+        while (stack.empty() == false) {
+            auto [u, w, m] = stack.back();
+            stack.pop_back();
+            if (m == -1) {
+                path.push_back(w);
+                continue;
+            }
+            stack.push_back({m, w, findMiddle(m, w)});
+            stack.push_back({u, m, findMiddle(u, m)});
+        }
+    }
+
+public:
+    ContractionHierarchy() = default;
+
+    static ContractionHierarchy build(const Graph& graph) {
+        Builder builder(graph);
+
+        ContractionHierarchy ch;
+        ch.n_ = graph.size();
+        ch.rank_ = builder.order();
+
+        std::vector<std::vector<Arc>> up(ch.n_), down(ch.n_);
+        for (int from = 0; from < ch.n_; ++from) {
+            for (const Arc& arc : builder.arcs()[from]) {
+                if (ch.rank_[from] < ch.rank_[arc.node])
+                    up[from].push_back(arc);
+                else
+                    down[arc.node].push_back({from, arc.cost, arc.middle});
+            }
+        }
+        ch.up_ = toSearchGraph(up);
+        ch.down_ = toSearchGraph(down);
+        ch.finish();
+        return ch;
+    }
+
+    int getNumShortcuts() const {
+        int shortcuts = 0;
+        for (int middle : up_.middles)
+            shortcuts += (middle != -1);
+        for (int middle : down_.middles)
+            shortcuts += (middle != -1);
+        return shortcuts;
+    }
+
+    // upward search from start and upward search in the reversed graph from end. a side stops once
+    // its closest node is no better than mu, since everything it would still settle is farther
+    std::pair<double, std::vector<int>> reconstructPath(int start, int end) {
+        forward_.newQuery();
+        backward_.newQuery();
+        forward_.update(start, 0, -1, -1);
+        backward_.update(end, 0, -1, -1);
+        forward_.heap.push_back({start, 0});
+        backward_.heap.push_back({end, 0});
+
+        double mu = POS_INF;
+        int meet = -1;
+        bool forward = true;
+        while (true) {
+            bool forward_done = forward_.heap.empty() || forward_.heap.front().value >= mu;
+            bool backward_done = backward_.heap.empty() || backward_.heap.front().value >= mu;
+            if (forward_done && backward_done)
+                break;
+
+            if (forward_done)
+                forward = false;
+            else if (backward_done)
+                forward = true;
+
+            if (forward)
+                step(up_, forward_, backward_, mu, meet);
+            else
+                step(down_, backward_, forward_, mu, meet);
+            forward = !forward;
+        }
+
+        std::vector<int> path;
+        if (meet == -1)
+            return {POS_INF, path};
+
+        // start -> meet from the forward prev chain, then meet -> end from the backward one
+        std::vector<int> up_chain;
+        for (int at = meet; at != start; at = forward_.prev[at])
+            up_chain.push_back(at);
+        std::reverse(up_chain.begin(), up_chain.end());
+
+        path.push_back(start);
+        int at = start;
+        for (int next : up_chain) {
+            unpack(at, next, forward_.middle[next], path);
+            at = next;
+        }
+        for (; at != end; at = backward_.prev[at])
+            unpack(at, backward_.prev[at], backward_.middle[at], path);
+
+        return {mu, path};
+    }
+
+    double distanceToNode(int start, int end) {
+        return reconstructPath(start, end).first;
+    }
+
+    void save(std::ostream& out) const {
+        auto write = [&](const auto& v) {
+            out.write(reinterpret_cast<const char*>(v.data()), sizeof(v[0]) * v.size());
+        };
+
+        out.write(reinterpret_cast<const char*>(&MAGIC), sizeof(MAGIC));
+        out.write(reinterpret_cast<const char*>(&n_), sizeof(n_));
+        write(rank_);
+        for (const SearchGraph* graph : {&up_, &down_}) {
+            int m = graph->targets.size();
+            out.write(reinterpret_cast<const char*>(&m), sizeof(m));
+            write(graph->offsets);
+            write(graph->targets);
+            write(graph->costs);
+            write(graph->middles);
+        }
+    }
+
+    static ContractionHierarchy load(std::istream& in) {
+        auto read = [&](auto& v, size_t size) {
+            v.resize(size);
+            in.read(reinterpret_cast<char*>(v.data()), sizeof(v[0]) * size);
+        };
+
+        ContractionHierarchy ch;
+        unsigned magic = 0;
+        in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+        in.read(reinterpret_cast<char*>(&ch.n_), sizeof(ch.n_));
+        if (!in || magic != MAGIC || ch.n_ < 0)
+            throw std::runtime_error("not a contraction hierarchy file");
+
+        read(ch.rank_, ch.n_);
+        for (SearchGraph* graph : {&ch.up_, &ch.down_}) {
+            int m = -1;
+            in.read(reinterpret_cast<char*>(&m), sizeof(m));
+            if (!in || m < 0)
+                throw std::runtime_error("truncated contraction hierarchy file");
+            read(graph->offsets, ch.n_ + 1);
+            read(graph->targets, m);
+            read(graph->costs, m);
+            read(graph->middles, m);
+        }
+        if (!in)
+            throw std::runtime_error("truncated contraction hierarchy file");
+
+        ch.finish();
+        return ch;
+    }
+};
+
+
+// reference distances for checking the hierarchy
+double dijkstra(const Graph& graph, int start, int end) {
+    std::vector<double> dist(graph.size(), POS_INF);
+    auto cmp = [](Node a, Node b) { return a.value > b.value; };
+    std::priority_queue<Node, std::vector<Node>, decltype(cmp)> pq(cmp);
+    dist[start] = 0;
+    pq.push({start, 0});
+    while (pq.empty() == false) {
+        auto [id, value] = pq.top();
+        pq.pop();
+        if (dist[id] < value)
+            continue;
+        if (id == end)
+            return value;
+        for (auto [cost, from, to] : graph[id]) {
+            if (value + cost < dist[to]) {
+                dist[to] = value + cost;
+                pq.push({to, dist[to]});
+            }
+        }
+    }
+    return POS_INF;
+}
+
+void testSmallGraph() {
+    int n = 5;
+    Graph g(n); // (cost, from, to)
+    g[0].push_back({4, 0, 1});
+    g[0].push_back({1, 0, 2});
+    g[1].push_back({1, 1, 3});
+    g[2].push_back({2, 2, 1});
+    g[2].push_back({5, 2, 3});
+    g[3].push_back({3, 3, 4});
+
+    // the hierarchy round trips through a stream the way it would be loaded from disk
+    std::stringstream file;
+    ContractionHierarchy::build(g).save(file);
+    ContractionHierarchy ch = ContractionHierarchy::load(file);
+
+    auto [cost, path] = ch.reconstructPath(0, 4);
+    std::cout << "Cost: " << cost << std::endl; // should be 7
+    // cheapest path: 0 2 1 3 4
+    for (int node : path)
+        std::cout << node << " ";
+    std::cout << std::endl;
+}
+
+void benchmarkRoadGrid(int width, int queries) {
+    // grid with random travel times, a rough stand in for a road network
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> travel_time(1, 10);
+    int n = width * width;
+    Graph g(n);
+    for (int y = 0; y < width; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int node = y * width + x;
+            if (x + 1 < width) {
+                g[node].push_back({travel_time(rng), node, node + 1});
+                g[node + 1].push_back({travel_time(rng), node + 1, node});
+            }
+            if (y + 1 < width) {
+                g[node].push_back({travel_time(rng), node, node + width});
+                g[node + width].push_back({travel_time(rng), node + width, node});
+            }
+        }
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    ContractionHierarchy ch = ContractionHierarchy::build(g);
+    auto t1 = std::chrono::steady_clock::now();
+
+    std::vector<std::pair<int, int>> pairs;
+    for (int i = 0; i < queries; ++i)
+        pairs.push_back({(int)(rng() % n), (int)(rng() % n)});
+
+    std::vector<double> expected;
+    for (auto [s, t] : pairs)
+        expected.push_back(dijkstra(g, s, t));
+    auto t2 = std::chrono::steady_clock::now();
+
+    int wrong = 0;
+    for (int i = 0; i < queries; ++i)
+        wrong += std::abs(ch.distanceToNode(pairs[i].first, pairs[i].second) - expected[i]) > 1e-9;
+    auto t3 = std::chrono::steady_clock::now();
+
+    auto ms = [](auto a, auto b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+    std::cout << width << "x" << width << " grid: preprocessing " << ms(t0, t1) << " ms, "
+              << ch.getNumShortcuts() << " shortcuts" << std::endl;
+    std::cout << "  dijkstra " << ms(t1, t2) / queries << " ms/query, ch " << ms(t2, t3) / queries
+              << " ms/query, wrong answers: " << wrong << std::endl;
+}
+
+
+int main() {
+    testSmallGraph();
+    benchmarkRoadGrid(50, 1000);
+
+    return 0;
+}
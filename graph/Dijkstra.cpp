@@ -4,6 +4,18 @@
 #include <limits>
 #include <math.h>
 #include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <sstream>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <random>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <set>
 
 struct Node {
     int id;
@@ -18,81 +30,1994 @@ using Graph = std::vector<std::vector<Edge>>;
 
 constexpr double POS_INF = std::numeric_limits<double>::infinity();
 
+// compressed sparse row adjacency, the edges leaving node are
+// targets[offsets[node]] ... targets[offsets[node + 1] - 1] with the matching costs
+struct CsrGraph {
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<double> costs;
+
+    int numNodes() const {
+        return offsets.size() - 1;
+    }
+
+    // calls f(edge index, to, cost) for every edge leaving node
+    template <typename F>
+    void forEachEdge(int node, F f) const {
+        for (int i = offsets[node]; i < offsets[node + 1]; ++i)
+            f(i, targets[i], costs[i]);
+    }
+
+    static CsrGraph fromGraph(const Graph& graph) {
+        CsrGraph csr;
+        csr.offsets.reserve(graph.size() + 1);
+        csr.offsets.push_back(0);
+        for (const auto& edges : graph) {
+            for (auto [cost, from, to] : edges) {
+                csr.targets.push_back(to);
+                csr.costs.push_back(cost);
+            }
+            csr.offsets.push_back(csr.targets.size());
+        }
+        return csr;
+    }
+
+    // same nodes with every edge flipped, needed for backward searches
+    CsrGraph reversed() const {
+        const int n = numNodes();
+        CsrGraph rev;
+        rev.offsets.assign(n + 1, 0);
+        for (int to : targets)
+            ++rev.offsets[to + 1];
+        for (int node = 0; node < n; ++node)
+            rev.offsets[node + 1] += rev.offsets[node];
+
+        std::vector<int> pos(rev.offsets.begin(), rev.offsets.end() - 1);
+        rev.targets.resize(targets.size());
+        rev.costs.resize(costs.size());
+        for (int from = 0; from < n; ++from) {
+            for (int i = offsets[from]; i < offsets[from + 1]; ++i) {
+                rev.targets[pos[targets[i]]] = from;
+                rev.costs[pos[targets[i]]++] = costs[i];
+            }
+        }
+        return rev;
+    }
+};
+
+// implicit 4 or 8 connected grid over a dense row major cost raster, nothing is stored per
+// edge. stepping into a cell costs the cell's raster value, sqrt 2 times that diagonally.
+// negative or infinite cells are blocked and diagonal steps can't cut a blocked corner
+class GridGraph {
+public:
+    // direction d and d ^ 1 are opposite, the first four are axis aligned
+    static constexpr int DX[8] = {1, -1, 0, 0, 1, -1, 1, -1};
+    static constexpr int DY[8] = {0, 0, 1, -1, 1, -1, -1, 1};
+    static constexpr double SQRT2 = 1.4142135623730951;
+
+private:
+    int width_, height_, connectivity_;
+
+    // borrowed, must outlive the graph
+    const std::vector<float>& cost_;
+
+public:
+    GridGraph(int width, int height, const std::vector<float>& cost, int connectivity = 8) :
+        width_(width), height_(height), connectivity_(connectivity), cost_(cost) {
+        if (connectivity != 4 && connectivity != 8)
+            throw std::invalid_argument("connectivity must be 4 or 8");
+        if ((long)cost.size() != (long)width * height)
+            throw std::invalid_argument("raster size doesn't match the grid");
+    }
+
+    int numNodes() const {
+        return width_ * height_;
+    }
+
+    int width() const {
+        return width_;
+    }
+
+    int height() const {
+        return height_;
+    }
+
+    int connectivity() const {
+        return connectivity_;
+    }
+
+    int node(int x, int y) const {
+        return y * width_ + x;
+    }
+
+    float cellCost(int node) const {
+        return cost_[node];
+    }
+
+    bool passable(int node) const {
+        return cost_[node] >= 0 && std::isfinite(cost_[node]);
+    }
+
+    // false outside the grid
+    bool passable(int x, int y) const {
+        return x >= 0 && x < width_ && y >= 0 && y < height_ && passable(node(x, y));
+    }
+
+    // edge ids are node * 8 + direction
+    template <typename F>
+    void forEachEdge(int node, F f) const {
+        const int x = node % width_, y = node / width_;
+        for (int d = 0; d < connectivity_; ++d) {
+            int nx = x + DX[d], ny = y + DY[d];
+            if (passable(nx, ny) == false)
+                continue;
+            if (d >= 4 && (passable(nx, y) == false || passable(x, ny) == false))
+                continue;
+
+            int to = ny * width_ + nx;
+            f(node * 8 + d, to, (d < 4) ? cost_[to] : cost_[to] * SQRT2);
+        }
+    }
+};
+
+// priority queue policies for dijkstra. they all offer resize(n), clear(), empty(),
+// push(node, key), top(), pop() and count pushes and pops. lazy queues can hand back
+// stale entries (a node whose distance dropped after it was pushed), the searches skip those
+
+// binary heap that pushes a duplicate instead of decreasing a key, so it holds O(E) entries
+class LazyBinaryHeap {
+private:
+    std::vector<Node> heap_;
+    long pushes_ = 0, pops_ = 0;
+
+    static bool cmp(const Node& a, const Node& b) {
+        return a.value > b.value;
+    }
+
+public:
+    void resize(int) {}
+
+    void clear() {
+        heap_.clear();
+    }
+
+    bool empty() const {
+        return heap_.empty();
+    }
+
+    void push(int node, double key) {
+        ++pushes_;
+        heap_.push_back({node, key});
+        std::push_heap(heap_.begin(), heap_.end(), cmp);
+    }
+
+    Node top() const {
+        return heap_.front();
+    }
+
+    void pop() {
+        ++pops_;
+        std::pop_heap(heap_.begin(), heap_.end(), cmp);
+        heap_.pop_back();
+    }
+
+    long pushes() const { return pushes_; }
+    long pops() const { return pops_; }
+};
+
+// indexed d-ary min heap (see data_structures/MinIndexedDHeap.cpp), trimmed to what the
+// eager queue needs and without the range checks
+template <typename T, int D = 4>
+class MinIndexedDHeap {
+private:
+    int size_ = 0;
+
+    // position map: ki -> node #
+    std::vector<int> pm_;
+
+    // inverse map: node # -> ki
+    std::vector<int> im_;
+
+    std::vector<T> values_;
+
+    bool less(int node_num_a, int node_num_b) const {
+        return values_[im_[node_num_a]] < values_[im_[node_num_b]];
+    }
+
+    void swap(int node_num_a, int node_num_b) {
+        std::swap(pm_[im_[node_num_a]], pm_[im_[node_num_b]]);
+        std::swap(im_[node_num_a], im_[node_num_b]);
+    }
+
+    void swim(int node_num) {
+        for (int parent = (node_num - 1) / D; node_num > 0 && less(node_num, parent); parent = (node_num - 1) / D) {
+            swap(node_num, parent);
+            node_num = parent;
+        }
+    }
+
+    void sink(int node_num) {
+        while (true) {
+            int smallest = node_num;
+            int from = node_num * D + 1;
+            int to = std::min(size_, from + D);
+            for (int kid = from; kid < to; ++kid) {
+                if (less(kid, smallest))
+                    smallest = kid;
+            }
+            if (smallest == node_num)
+                return;
+            swap(node_num, smallest);
+            node_num = smallest;
+        }
+    }
+
+public:
+    MinIndexedDHeap(int max_size = 0) {
+        pm_.assign(max_size, -1);
+        im_.assign(max_size, -1);
+        values_.resize(max_size);
+    }
+
+    int maxSize() const {
+        return pm_.size();
+    }
+
+    bool isEmpty() const {
+        return size_ == 0;
+    }
+
+    bool contains(int ki) const {
+        return pm_[ki] != -1;
+    }
+
+    void insert(int ki, T value) {
+        pm_[ki] = size_;
+        im_[size_] = ki;
+        values_[ki] = value;
+        swim(size_++);
+    }
+
+    void decrease(int ki, T value) {
+        if (value < values_[ki]) {
+            values_[ki] = value;
+            swim(pm_[ki]);
+        }
+    }
+
+    int peekMinKeyIndex() const {
+        return im_[0];
+    }
+
+    T peekMinValue() const {
+        return values_[im_[0]];
+    }
+
+    int pollMinKeyIndex() {
+        int min_ki = im_[0];
+        swap(0, --size_);
+        sink(0);
+        pm_[min_ki] = -1;
+        im_[size_] = -1;
+        return min_ki;
+    }
+
+    // O(size) instead of O(max_size)
+    void clear() {
+        for (int i = 0; i < size_; ++i) {
+            pm_[im_[i]] = -1;
+            im_[i] = -1;
+        }
+        size_ = 0;
+    }
+};
+
+// decrease key queue, at most one entry per node so it never holds stale entries
+template <int D = 4>
+class EagerDHeap {
+private:
+    MinIndexedDHeap<double, D> heap_;
+    long pushes_ = 0, pops_ = 0;
+
+public:
+    void resize(int n) {
+        if (heap_.maxSize() < n)
+            heap_ = MinIndexedDHeap<double, D>(n);
+    }
+
+    void clear() {
+        heap_.clear();
+    }
+
+    bool empty() const {
+        return heap_.isEmpty();
+    }
+
+    void push(int node, double key) {
+        ++pushes_;
+        if (heap_.contains(node))
+            heap_.decrease(node, key);
+        else
+            heap_.insert(node, key);
+    }
+
+    Node top() const {
+        return {heap_.peekMinKeyIndex(), heap_.peekMinValue()};
+    }
+
+    void pop() {
+        ++pops_;
+        heap_.pollMinKeyIndex();
+    }
+
+    long pushes() const { return pushes_; }
+    long pops() const { return pops_; }
+};
+
+// radix heap for monotone keys, every key pushed must be >= the last key popped, which
+// dijkstra guarantees with non negative costs. non negative doubles order the same as their
+// bit patterns, so entries are bucketed by the highest bit where they differ from the last
+// popped key and each entry only ever moves to lower buckets
+class RadixHeap {
+private:
+    std::vector<Node> buckets_[65];
+    uint64_t last_ = 0;
+    int size_ = 0;
+    long pushes_ = 0, pops_ = 0;
+
+    static uint64_t bits(double key) {
+        uint64_t b;
+        std::memcpy(&b, &key, sizeof(b));
+        return b;
+    }
+
+    int bucketOf(double key) const {
+        uint64_t b = bits(key);
+        return (b == last_) ? 0 : 64 - __builtin_clzll(b ^ last_);
+    }
+
+    // refills bucket 0 from the lowest non empty bucket
+    void pull() {
+        if (buckets_[0].empty() == false)
+            return;
+
+        int i = 1;
+        while (buckets_[i].empty())
+            ++i;
+
+        double min_key = buckets_[i][0].value;
+        for (const Node& node : buckets_[i])
+            min_key = std::min(min_key, node.value);
+        last_ = bits(min_key);
+
+        for (const Node& node : buckets_[i])
+            buckets_[bucketOf(node.value)].push_back(node);
+        buckets_[i].clear();
+    }
+
+public:
+    void resize(int) {}
+
+    void clear() {
+        for (auto& bucket : buckets_)
+            bucket.clear();
+        last_ = 0;
+        size_ = 0;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    void push(int node, double key) {
+        if (key < 0 || bits(key) < last_)
+            throw std::logic_error("radix heap keys must be non negative and monotone");
+        ++pushes_;
+        ++size_;
+        buckets_[bucketOf(key)].push_back({node, key});
+    }
+
+    Node top() {
+        pull();
+        return buckets_[0].back();
+    }
+
+    void pop() {
+        pull();
+        ++pops_;
+        --size_;
+        buckets_[0].pop_back();
+    }
+
+    long pushes() const { return pushes_; }
+    long pops() const { return pops_; }
+};
+
+// dial's bucket queue for integer costs, bucket k holds the nodes at tentative distance k.
+// the buckets form a ring that doubles whenever a key lands past its end, so the max edge
+// cost doesn't have to be known up front
+class DialQueue {
+private:
+    std::vector<std::vector<int>> ring_;
+    long cursor_ = 0;
+    int size_ = 0;
+    long pushes_ = 0, pops_ = 0;
+
+    void grow() {
+        const long old_size = ring_.size();
+        std::vector<std::vector<int>> old_ring(std::max(1L, 2 * old_size));
+        old_ring.swap(ring_);
+
+        // slot s of the old ring held key cursor_ + ((s - cursor_) mod old_size)
+        for (long s = 0; s < old_size; ++s) {
+            long key = cursor_ + ((s - cursor_) % old_size + old_size) % old_size;
+            auto& slot = ring_[key % ring_.size()];
+            slot.insert(slot.end(), old_ring[s].begin(), old_ring[s].end());
+        }
+    }
+
+    void advance() {
+        while (ring_[cursor_ % ring_.size()].empty())
+            ++cursor_;
+    }
+
+public:
+    void resize(int) {}
+
+    void clear() {
+        for (auto& slot : ring_)
+            slot.clear();
+        cursor_ = 0;
+        size_ = 0;
+    }
+
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    void push(int node, double key) {
+        long k = (long)key;
+        if (k != key)
+            throw std::invalid_argument("dial's queue needs integer keys");
+        if (k < cursor_)
+            throw std::logic_error("dial's queue keys must be monotone");
+        while (k - cursor_ >= (long)ring_.size())
+            grow();
+
+        ++pushes_;
+        ++size_;
+        ring_[k % ring_.size()].push_back(node);
+    }
+
+    Node top() {
+        advance();
+        return {ring_[cursor_ % ring_.size()].back(), (double)cursor_};
+    }
+
+    void pop() {
+        advance();
+        ++pops_;
+        --size_;
+        ring_[cursor_ % ring_.size()].pop_back();
+    }
+
+    long pushes() const { return pushes_; }
+    long pops() const { return pops_; }
+};
+
+// per query state. entries are reset lazily: they only count for the current query when
+// their stamp matches the epoch, so a query costs O(nodes touched) instead of O(n).
+// one workspace per thread lets queries on the same graph run concurrently
+template <typename Queue = LazyBinaryHeap>
+class DijkstraWorkspace {
+private:
+    unsigned epoch_ = 0;
+    std::vector<unsigned> stamp_, settled_, target_;
+    std::vector<double> dist_;
+    std::vector<int> prev_;
+
+public:
+    // reused between queries so it never reallocates once warmed up
+    Queue queue_;
+
+    DijkstraWorkspace(int n = 0) {
+        resize(n);
+    }
+
+    void resize(int n) {
+        if ((int)stamp_.size() >= n)
+            return;
+        stamp_.resize(n, 0);
+        settled_.resize(n, 0);
+        target_.resize(n, 0);
+        dist_.resize(n);
+        prev_.resize(n);
+        queue_.resize(n);
+    }
+
+    void newQuery() {
+        queue_.clear();
+        if (++epoch_ == 0) {
+            // wrapped around, stale stamps could now look current
+            std::fill(stamp_.begin(), stamp_.end(), 0);
+            std::fill(settled_.begin(), settled_.end(), 0);
+            std::fill(target_.begin(), target_.end(), 0);
+            epoch_ = 1;
+        }
+    }
+
+    double dist(int node) const {
+        return (stamp_[node] == epoch_) ? dist_[node] : POS_INF;
+    }
+
+    int prev(int node) const {
+        return (stamp_[node] == epoch_) ? prev_[node] : -1;
+    }
+
+    void update(int node, double dist, int prev) {
+        stamp_[node] = epoch_;
+        dist_[node] = dist;
+        prev_[node] = prev;
+    }
+
+    bool settled(int node) const {
+        return settled_[node] == epoch_;
+    }
+
+    void settle(int node) {
+        settled_[node] = epoch_;
+    }
+
+    // targets of a one to many query, returns false if node was already marked
+    bool markTarget(int node) {
+        if (target_[node] == epoch_)
+            return false;
+        target_[node] = epoch_;
+        return true;
+    }
+
+    bool isTarget(int node) const {
+        return target_[node] == epoch_;
+    }
+};
+
+// edge filter that lets every edge through
+struct AllEdges {
+    bool operator()(int, int) const {
+        return true;
+    }
+};
+
+// runs on any graph type with numNodes() and forEachEdge(node, f), CsrGraph or GridGraph
+template <typename Queue = LazyBinaryHeap, typename GraphType = CsrGraph>
 class Dijkstra {
-private:   
-    Graph graph_;
+public:
+    using Workspace = DijkstraWorkspace<Queue>;
+
+private:
+    // borrowed, must outlive the solver
+    const GraphType& graph_;
+    int n_;
+
+    // optional, only the bidirectional queries use it
+    const GraphType* reverse_graph_;
+
+    // used by the overloads that don't take a workspace
+    Workspace workspace_, reverse_workspace_;
+
+    // drops queue entries for nodes that were settled or improved after being pushed
+    static void discardStale(Workspace& ws) {
+        auto& pq = ws.queue_;
+        while (pq.empty() == false && (ws.settled(pq.top().id) || ws.dist(pq.top().id) < pq.top().value))
+            pq.pop();
+    }
+
+    // settles nodes in order of distance until done(node) returns true for the node
+    // just settled or everything reachable is settled. only edges for which
+    // allowed(edge index in graph_, to) holds are relaxed. ws must already be set up for the query
+    template <typename Done, typename Allowed = AllEdges>
+    void search(int start, Workspace& ws, Done done, Allowed allowed = Allowed()) const {
+        ws.update(start, 0, -1);
+
+        auto& pq = ws.queue_;
+        pq.push(start, 0);
+
+        while (pq.empty() == false) {
+            auto [id, value] = pq.top();
+            pq.pop();
+
+            // already found better path, can't get better
+            if (ws.settled(id) || ws.dist(id) < value)
+                continue;
+            ws.settle(id);
+
+            // once we've visited all nodes spanning from end node, can't get better
+            if (done(id))
+                return;
+
+            graph_.forEachEdge(id, [&](int edge, int to, double cost) {
+                // can't get shorter path revisitng a node already visited
+                if (ws.settled(to) || allowed(edge, to) == false)
+                    return;
+
+                // try to relax edges
+                double new_dist = value + cost;
+                if (new_dist < ws.dist(to)) {
+                    ws.update(to, new_dist, id);
+                    pq.push(to, new_dist);
+                }
+            });
+        }
+    }
+
+public:
+    Dijkstra(const GraphType& graph, const GraphType* reverse_graph = nullptr) :
+        graph_(graph), n_(graph.numNodes()), reverse_graph_(reverse_graph), workspace_(n_) {}
+
+    double distanceToNode(int start, int end) {
+        return distanceToNode(start, end, workspace_);
+    }
+
+    // end = -1 settles everything reachable and leaves the distances in ws
+    double distanceToNode(int start, int end, Workspace& ws) const {
+        ws.resize(n_);
+        ws.newQuery();
+        search(start, ws, [&](int id) { return id == end; });
+        return (end == -1) ? POS_INF : ws.dist(end);
+    }
+
+    // one to many: writes the distance from start to targets[j] into row[j]. the search
+    // stops as soon as the last target is settled instead of exploring the whole graph
+    void distancesToTargets(int start, const std::vector<int>& targets, double* row, Workspace& ws) const {
+        ws.resize(n_);
+        ws.newQuery();
+
+        int remaining = 0;
+        for (int target : targets)
+            remaining += ws.markTarget(target);
+        if (remaining > 0)
+            search(start, ws, [&](int id) { return ws.isTarget(id) && --remaining == 0; });
+
+        for (size_t j = 0; j < targets.size(); ++j)
+            row[j] = ws.dist(targets[j]);
+    }
+
+    // many to many: one search per source, sources handed out to num_threads threads that each
+    // have their own workspace. returns a row major sources.size() x targets.size() matrix
+    std::vector<double> distanceTable(const std::vector<int>& sources, const std::vector<int>& targets,
+                                      int num_threads) const {
+        std::vector<double> table(sources.size() * targets.size());
+        if (table.empty())
+            return table;
+        std::atomic<size_t> next_source(0);
+
+        auto work = [&]() {
+            Workspace ws(n_);
+            for (size_t i = next_source++; i < sources.size(); i = next_source++)
+                distancesToTargets(sources[i], targets, table.data() + i * targets.size(), ws);
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 1; t < num_threads; ++t)
+            threads.emplace_back(work);
+        work();
+        for (auto& thread : threads)
+            thread.join();
+
+        return table;
+    }
+
+    std::pair<double, std::vector<int>> reconstructPath(int start, int end) {
+        return reconstructPath(start, end, workspace_);
+    }
+
+    std::pair<double, std::vector<int>> reconstructPath(int start, int end, Workspace& ws) const {
+        std::vector<int> path;
+
+        double dist = distanceToNode(start, end, ws);
+        if (isinf(dist) == true)
+            return {dist, path};
+
+        for (int at = end; at != -1; at = ws.prev(at))
+            path.push_back(at);
+
+        std::reverse(path.begin(), path.end());
+        return {dist, path};
+    }
+
+    // shortest path that only uses edges for which allowed(edge index in the csr graph, to) holds
+    template <typename Allowed>
+    std::pair<double, std::vector<int>> restrictedPath(int start, int end, Workspace& ws, Allowed allowed) const {
+        ws.resize(n_);
+        ws.newQuery();
+        search(start, ws, [&](int id) { return id == end; }, allowed);
+
+        std::vector<int> path;
+        if (isinf(ws.dist(end)) == true)
+            return {POS_INF, path};
+
+        for (int at = end; at != -1; at = ws.prev(at))
+            path.push_back(at);
+        std::reverse(path.begin(), path.end());
+        return {ws.dist(end), path};
+    }
+
+    // searches forward from start and backward from end at the same time, alternating
+    // between the two frontiers. stops once top_f + top_b >= mu, the best start -> end
+    // distance seen so far, and splices the two prev chains at the meeting node
+    std::pair<double, std::vector<int>> bidirectionalPath(int start, int end) {
+        return bidirectionalPath(start, end, workspace_, reverse_workspace_);
+    }
+
+    std::pair<double, std::vector<int>> bidirectionalPath(int start, int end,
+                                                          Workspace& fwd, Workspace& bwd) const {
+        if (reverse_graph_ == nullptr)
+            throw std::logic_error("bidirectional search needs the reverse graph");
+
+        fwd.resize(n_);
+        bwd.resize(n_);
+        fwd.newQuery();
+        bwd.newQuery();
+        fwd.update(start, 0, -1);
+        bwd.update(end, 0, -1);
+        fwd.queue_.push(start, 0);
+        bwd.queue_.push(end, 0);
+
+        double mu = (start == end) ? 0 : POS_INF;
+        int meet = (start == end) ? start : -1;
+
+        // settles the closest node on one side, checking every edge it relaxes
+        // against the other side's distances for a shorter start -> end path
+        auto step = [&](const GraphType& graph, Workspace& ws, const Workspace& other) {
+            auto& pq = ws.queue_;
+            auto [id, value] = pq.top();
+            pq.pop();
+            ws.settle(id);
+
+            graph.forEachEdge(id, [&](int, int to, double cost) {
+                double new_dist = value + cost;
+                if (ws.settled(to) == false && new_dist < ws.dist(to)) {
+                    ws.update(to, new_dist, id);
+                    pq.push(to, new_dist);
+                }
+                if (new_dist + other.dist(to) < mu) {
+                    mu = new_dist + other.dist(to);
+                    meet = to;
+                }
+            });
+        };
+
+        for (bool forward = true; ; forward = !forward) {
+            discardStale(fwd);
+            discardStale(bwd);
+            if (fwd.queue_.empty() || bwd.queue_.empty())
+                break;
+            if (fwd.queue_.top().value + bwd.queue_.top().value >= mu)
+                break;
+
+            if (forward)
+                step(graph_, fwd, bwd);
+            else
+                step(*reverse_graph_, bwd, fwd);
+        }
+
+        std::vector<int> path;
+        if (meet == -1)
+            return {POS_INF, path};
+
+        for (int at = meet; at != -1; at = fwd.prev(at))
+            path.push_back(at);
+        std::reverse(path.begin(), path.end());
+        for (int at = bwd.prev(meet); at != -1; at = bwd.prev(at))
+            path.push_back(at);
+
+        return {mu, path};
+    }
+
+};
+
+// fixed size array of bits
+class Bitset {
+private:
+    std::vector<uint64_t> words_;
+
+public:
+    Bitset(int n = 0) : words_((n + 63) / 64, 0) {}
+
+    bool test(int i) const {
+        return (words_[i >> 6] >> (i & 63)) & 1;
+    }
+
+    void set(int i) {
+        words_[i >> 6] |= uint64_t(1) << (i & 63);
+    }
+
+    void reset(int i) {
+        words_[i >> 6] &= ~(uint64_t(1) << (i & 63));
+    }
+};
+
+// yen's k shortest loopless paths. every accepted path is used as a root: for each spur node
+// along it, the nodes before the spur and the next edges of accepted paths sharing that prefix
+// are masked out and dijkstra finds the best way to finish. masks are bitsets over the nodes
+// and csr edges, set and cleared per spur, so the graph is never copied
+class KShortestPaths {
+public:
+    struct Path {
+        double cost;
+        std::vector<int> nodes;
+
+        // index of the spur node where it left the path it was found from
+        int deviation;
+    };
+
+private:
+    const CsrGraph& graph_;
+    int n_;
+    int num_threads_;
+    Dijkstra<> dijkstra_;
+
+    // masks and workspace of one spur search, one per thread
+    struct SpurState {
+        Bitset node_mask, edge_mask;
+        std::vector<int> masked_nodes, masked_edges;
+        DijkstraWorkspace<> ws;
+    };
+    std::vector<SpurState> states_;
+
+    // cheapest of the parallel edges from -> to
+    double edgeCost(int from, int to) const {
+        double cost = POS_INF;
+        for (int i = graph_.offsets[from]; i < graph_.offsets[from + 1]; ++i) {
+            if (graph_.targets[i] == to)
+                cost = std::min(cost, graph_.costs[i]);
+        }
+        return cost;
+    }
+
+    // best path leaving path at its i-th node, cost POS_INF if there is none
+    Path spur(const Path& path, int i, int end, const std::vector<Path>& accepted, SpurState& state) const {
+        const int spur_node = path.nodes[i];
+
+        // the root must not be revisited, the tail has to stay loopless
+        for (int j = 0; j < i; ++j) {
+            state.node_mask.set(path.nodes[j]);
+            state.masked_nodes.push_back(path.nodes[j]);
+        }
+
+        // and mustn't repeat the next edge of any accepted path with the same root
+        for (const Path& other : accepted) {
+            if ((int)other.nodes.size() <= i + 1 ||
+                std::equal(path.nodes.begin(), path.nodes.begin() + i + 1, other.nodes.begin()) == false)
+                continue;
+            for (int e = graph_.offsets[spur_node]; e < graph_.offsets[spur_node + 1]; ++e) {
+                if (graph_.targets[e] == other.nodes[i + 1] && state.edge_mask.test(e) == false) {
+                    state.edge_mask.set(e);
+                    state.masked_edges.push_back(e);
+                }
+            }
+        }
+
+        auto [tail_cost, tail] = dijkstra_.restrictedPath(spur_node, end, state.ws, [&](int edge, int to) {
+            return state.edge_mask.test(edge) == false && state.node_mask.test(to) == false;
+        });
+
+        for (int node : state.masked_nodes)
+            state.node_mask.reset(node);
+        for (int edge : state.masked_edges)
+            state.edge_mask.reset(edge);
+        state.masked_nodes.clear();
+        state.masked_edges.clear();
+
+        if (isinf(tail_cost) == true)
+            return {POS_INF, {}, i};
+
+        Path candidate = {tail_cost, std::vector<int>(path.nodes.begin(), path.nodes.begin() + i), i};
+        for (int j = 0; j < i; ++j)
+            candidate.cost += edgeCost(path.nodes[j], path.nodes[j + 1]);
+        candidate.nodes.insert(candidate.nodes.end(), tail.begin(), tail.end());
+        return candidate;
+    }
+
+public:
+    KShortestPaths(const CsrGraph& graph, int num_threads = 1) :
+        graph_(graph), n_(graph.numNodes()), num_threads_(std::max(1, num_threads)), dijkstra_(graph) {
+        for (int t = 0; t < num_threads_; ++t)
+            states_.push_back({Bitset(n_), Bitset(graph.targets.size()), {}, {}, DijkstraWorkspace<>(n_)});
+    }
+
+    // up to k loopless start -> end paths, cheapest first
+    std::vector<Path> find(int start, int end, int k) {
+        std::vector<Path> accepted;
+        if (k <= 0)
+            return accepted;
+
+        auto [cost, nodes] = dijkstra_.reconstructPath(start, end);
+        if (isinf(cost) == true)
+            return accepted;
+        accepted.push_back({cost, nodes, 0});
+
+        // candidate pool as a min heap, ties broken on the node sequence so results are repeatable
+        auto cmp = [](const Path& a, const Path& b) {
+            return (a.cost != b.cost) ? a.cost > b.cost : a.nodes > b.nodes;
+        };
+        std::priority_queue<Path, std::vector<Path>, decltype(cmp)> candidates(cmp);
+        std::set<std::vector<int>> seen = {nodes};
+
+        while ((int)accepted.size() < k) {
+            const Path last = accepted.back();
+
+            // lawler: spurs before the deviation were already tried from the path last came from
+            const int first = last.deviation;
+            const int count = (int)last.nodes.size() - 1 - first;
+            std::vector<Path> spurs(std::max(0, count));
+
+            // spur searches for one root are independent, each thread owns its masks
+            auto work = [&](int thread_id) {
+                for (int j = thread_id; j < count; j += num_threads_)
+                    spurs[j] = spur(last, first + j, end, accepted, states_[thread_id]);
+            };
+            std::vector<std::thread> threads;
+            for (int t = 1; t < std::min(num_threads_, count); ++t)
+                threads.emplace_back(work, t);
+            work(0);
+            for (auto& thread : threads)
+                thread.join();
+
+            for (Path& candidate : spurs) {
+                if (isinf(candidate.cost) == false && seen.insert(candidate.nodes).second)
+                    candidates.push(std::move(candidate));
+            }
+
+            if (candidates.empty())
+                break;
+            accepted.push_back(candidates.top());
+            candidates.pop();
+        }
+
+        return accepted;
+    }
+};
+
+// single source shortest path tree that follows edge cost changes (ramalingam and reps).
+// a batch first detaches the subtrees hanging off tree edges that got more expensive, seeds
+// them from their unaffected in-neighbours, seeds the heads of cheaper edges, and then runs
+// dijkstra from those seeds only. nodes outside the affected region are never looked at
+class DynamicShortestPaths {
+public:
+    // edge is an index into the csr graph's targets / costs
+    struct WeightChange {
+        int edge;
+        double cost;
+    };
+
+private:
+    int n_, source_;
+
+    // own copy, costs are updated in place
+    CsrGraph graph_;
+
+    // tail of every edge and the edges entering each node, for seeding detached nodes
+    std::vector<int> edge_from_, in_offsets_, in_edges_;
+
+    std::vector<double> dist_;
+
+    // tree edge into each node, -1 for the source and unreachable nodes
+    std::vector<int> prev_edge_;
+
+    std::vector<Node> heap_;
+    std::vector<char> affected_;
+
+    // nodes whose distance or parent was touched by the current batch
+    std::vector<unsigned> repaired_;
+    unsigned epoch_ = 0;
+    int num_repaired_ = 0;
+
+    static bool heapCmp(const Node& a, const Node& b) {
+        return a.value > b.value;
+    }
+
+    void markRepaired(int node) {
+        if (repaired_[node] != epoch_) {
+            repaired_[node] = epoch_;
+            ++num_repaired_;
+        }
+    }
+
+    void relax(int edge, double new_dist) {
+        int to = graph_.targets[edge];
+        if (new_dist < dist_[to]) {
+            dist_[to] = new_dist;
+            prev_edge_[to] = edge;
+            markRepaired(to);
+            heap_.push_back({to, new_dist});
+            std::push_heap(heap_.begin(), heap_.end(), heapCmp);
+        }
+    }
+
+    // plain dijkstra from whatever is in the heap
+    void propagate() {
+        while (heap_.empty() == false) {
+            std::pop_heap(heap_.begin(), heap_.end(), heapCmp);
+            auto [id, value] = heap_.back();
+            heap_.pop_back();
+            if (dist_[id] < value)
+                continue;
+
+            for (int i = graph_.offsets[id]; i < graph_.offsets[id + 1]; ++i)
+                relax(i, value + graph_.costs[i]);
+        }
+    }
+
+public:
+    DynamicShortestPaths(const CsrGraph& graph, int source) :
+        n_(graph.numNodes()), source_(source), graph_(graph), dist_(n_, POS_INF), prev_edge_(n_, -1),
+        affected_(n_, false), repaired_(n_, 0) {
+        for (double cost : graph_.costs) {
+            if (cost < 0)
+                throw std::invalid_argument("dynamic shortest paths need non negative costs");
+        }
+
+        edge_from_.resize(graph_.targets.size());
+        in_offsets_.assign(n_ + 1, 0);
+        for (int from = 0; from < n_; ++from) {
+            for (int i = graph_.offsets[from]; i < graph_.offsets[from + 1]; ++i) {
+                edge_from_[i] = from;
+                ++in_offsets_[graph_.targets[i] + 1];
+            }
+        }
+        for (int node = 0; node < n_; ++node)
+            in_offsets_[node + 1] += in_offsets_[node];
+        std::vector<int> pos(in_offsets_.begin(), in_offsets_.end() - 1);
+        in_edges_.resize(graph_.targets.size());
+        for (int i = 0; i < (int)graph_.targets.size(); ++i)
+            in_edges_[pos[graph_.targets[i]]++] = i;
+
+        dist_[source_] = 0;
+        heap_.push_back({source_, 0});
+        propagate();
+    }
+
+    double dist(int node) const {
+        return dist_[node];
+    }
+
+    // parent in the shortest path tree, -1 for the source and unreachable nodes
+    int prev(int node) const {
+        return (prev_edge_[node] == -1) ? -1 : edge_from_[prev_edge_[node]];
+    }
+
+    std::vector<int> path(int node) const {
+        std::vector<int> path;
+        if (isinf(dist_[node]) == true)
+            return path;
+        for (int at = node; at != -1; at = prev(at))
+            path.push_back(at);
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    // index of the cheapest edge from -> to, -1 if there is none
+    int edgeIndex(int from, int to) const {
+        int best = -1;
+        for (int i = graph_.offsets[from]; i < graph_.offsets[from + 1]; ++i) {
+            if (graph_.targets[i] == to && (best == -1 || graph_.costs[i] < graph_.costs[best]))
+                best = i;
+        }
+        return best;
+    }
+
+    // applies every change and repairs the tree once, returns the number of nodes repaired
+    int applyBatch(const std::vector<WeightChange>& changes) {
+        num_repaired_ = 0;
+        if (++epoch_ == 0) {
+            std::fill(repaired_.begin(), repaired_.end(), 0);
+            epoch_ = 1;
+        }
+
+        // detach the subtrees below tree edges that got more expensive
+        std::vector<int> detached;
+        for (auto [edge, cost] : changes) {
+            if (cost < 0)
+                throw std::invalid_argument("dynamic shortest paths need non negative costs");
+            double old_cost = graph_.costs[edge];
+            graph_.costs[edge] = cost;
+
+            int to = graph_.targets[edge];
+            if (cost > old_cost && prev_edge_[to] == edge && affected_[to] == false) {
+                affected_[to] = true;
+                detached.push_back(to);
+            }
+        }
+        for (size_t head = 0; head < detached.size(); ++head) {
+            int node = detached[head];
+            for (int i = graph_.offsets[node]; i < graph_.offsets[node + 1]; ++i) {
+                int child = graph_.targets[i];
+                if (prev_edge_[child] == i && affected_[child] == false) {
+                    affected_[child] = true;
+                    detached.push_back(child);
+                }
+            }
+        }
+        for (int node : detached) {
+            dist_[node] = POS_INF;
+            prev_edge_[node] = -1;
+            markRepaired(node);
+        }
+
+        // reattach detached nodes to their best unaffected in-neighbour
+        for (int node : detached) {
+            for (int j = in_offsets_[node]; j < in_offsets_[node + 1]; ++j) {
+                int edge = in_edges_[j];
+                if (affected_[edge_from_[edge]] == false)
+                    relax(edge, dist_[edge_from_[edge]] + graph_.costs[edge]);
+            }
+        }
+        for (int node : detached)
+            affected_[node] = false;
+
+        // cheaper edges can only shorten paths through their head
+        for (auto [edge, cost] : changes) {
+            double from_dist = dist_[edge_from_[edge]];
+            if (isinf(from_dist) == false)
+                relax(edge, from_dist + graph_.costs[edge]);
+        }
+
+        propagate();
+        return num_repaired_;
+    }
+
+    int getNumRepaired() const {
+        return num_repaired_;
+    }
+};
+
+// plain dijkstra expressed as an a* heuristic
+struct ZeroHeuristic {
+    double operator()(int, int) const {
+        return 0;
+    }
+};
+
+// goal directed dijkstra. heuristic(node, target) is a lower bound on the remaining distance
+// and is a template parameter so the call inlines into the relaxation loop
+template <typename Heuristic>
+class AStar {
+private:
+    const CsrGraph& graph_;
     int n_;
-    std::vector<double> dist_;
-    std::vector<int> prev_;
+    Heuristic heuristic_;
 
+    DijkstraWorkspace<> workspace_;
 
 public:
-    Dijkstra(Graph& graph) : n_(graph.size()), graph_(graph) {}
+    AStar(const CsrGraph& graph, Heuristic heuristic) :
+        graph_(graph), n_(graph.numNodes()), heuristic_(heuristic), workspace_(n_) {}
 
-    double distanceToNode(int start, int end) {
-        dist_ = std::vector<double>(n_, POS_INF);
-        dist_[start] = 0;
+    std::pair<double, std::vector<int>> reconstructPath(int start, int end) {
+        return reconstructPath(start, end, workspace_);
+    }
 
-        // min heap
-        auto cmp = [](Node a, Node b ) { return a.value > b.value; };
-        std::priority_queue<Node, std::vector<Node>, decltype(cmp)> pq(cmp);
-        pq.push({start, 0});
+    std::pair<double, std::vector<int>> reconstructPath(int start, int end, DijkstraWorkspace<>& ws) const {
+        ws.resize(n_);
+        ws.newQuery();
+        ws.update(start, 0, -1);
 
-        // visitation history
-        std::vector<bool> visited(n_, false);
-        prev_ = std::vector<int>(n_, -1);
+        // keyed by cost to come + estimated cost to go
+        auto& pq = ws.queue_;
+        pq.push(start, heuristic_(start, end));
 
+        std::vector<int> path;
         while (pq.empty() == false) {
-            auto [id, value] = pq.top();
+            int id = pq.top().id;
             pq.pop();
 
-            // already found better path, can't get better
-            if (dist_[id] < value ) 
+            if (ws.settled(id))
                 continue;
+            ws.settle(id);
 
-            for (auto [cost, from, to] : graph_[id]) {
-                // can't get shorter path revisitng a node already visited
-                if (visited[to] == true)
+            if (id == end) {
+                for (int at = end; at != -1; at = ws.prev(at))
+                    path.push_back(at);
+                std::reverse(path.begin(), path.end());
+                return {ws.dist(end), path};
+            }
+
+            for (int i = graph_.offsets[id]; i < graph_.offsets[id + 1]; ++i) {
+                int to = graph_.targets[i];
+                if (ws.settled(to))
                     continue;
-                
-                // try to relax edges
-                double new_dist = dist_[id] + cost;
-                if (new_dist < dist_[to]) {
-                    prev_[to] = from;
-                    dist_[to] = new_dist;
-                    pq.push({to, new_dist});
+
+                double new_dist = ws.dist(id) + graph_.costs[i];
+                if (new_dist < ws.dist(to)) {
+                    // an infinite estimate means end can't be reached from to
+                    double estimate = heuristic_(to, end);
+                    if (isinf(estimate))
+                        continue;
+                    ws.update(to, new_dist, id);
+                    pq.push(to, new_dist + estimate);
                 }
             }
+        }
 
-            // once we've visited all nodes spanning from end node, can't get better
-            if (id == end)
-                return dist_[end];
+        return {POS_INF, path};
+    }
+
+};
+
+// landmark distance tables for ALT (a*, landmarks, triangle inequality). for every node v and
+// landmark L we keep d(L, v) and d(v, L) as floats, node major so a lookup touches one row
+class Landmarks {
+private:
+    int n_ = 0, k_ = 0;
+    std::vector<int> landmarks_;
+    std::vector<float> from_landmark_, to_landmark_;
+
+    static constexpr unsigned MAGIC = 0x414c5431; // "ALT1"
+
+    // greedy farthest selection by hop count, ignoring edge directions
+    static std::vector<int> selectLandmarks(const CsrGraph& graph, const CsrGraph& reverse_graph, int k) {
+        const int n = graph.numNodes();
+        std::vector<int> hops(n, std::numeric_limits<int>::max());
+        std::vector<int> chosen;
+        std::vector<int> queue;
+
+        int next = 0;
+        for (int i = 0; i < k && next != -1; ++i) {
+            chosen.push_back(next);
+
+            // multi source bfs from every landmark so far, hops only ever shrink
+            hops[next] = 0;
+            queue.assign(1, next);
+            for (size_t head = 0; head < queue.size(); ++head) {
+                int node = queue[head];
+                for (const CsrGraph* g : {&graph, &reverse_graph}) {
+                    for (int j = g->offsets[node]; j < g->offsets[node + 1]; ++j) {
+                        int to = g->targets[j];
+                        if (hops[node] + 1 < hops[to]) {
+                            hops[to] = hops[node] + 1;
+                            queue.push_back(to);
+                        }
+                    }
+                }
+            }
+
+            // unreached nodes (other components) are the farthest of all
+            next = -1;
+            for (int node = 0; node < n; ++node) {
+                if (hops[node] > 0 && (next == -1 || hops[node] > hops[next]))
+                    next = node;
+            }
+        }
+
+        return chosen;
+    }
+
+public:
+    Landmarks() = default;
+
+    // runs a full dijkstra from and to each of k landmarks, spread over num_threads threads
+    static Landmarks build(const CsrGraph& graph, const CsrGraph& reverse_graph, int k, int num_threads) {
+        Landmarks alt;
+        alt.n_ = graph.numNodes();
+        alt.landmarks_ = selectLandmarks(graph, reverse_graph, k);
+        alt.k_ = alt.landmarks_.size();
+        alt.from_landmark_.resize((size_t)alt.n_ * alt.k_);
+        alt.to_landmark_.resize((size_t)alt.n_ * alt.k_);
+
+        // each thread owns whole landmarks (columns), so writes never overlap
+        auto work = [&](int thread_id) {
+            Dijkstra forward(graph), backward(reverse_graph);
+            DijkstraWorkspace ws(alt.n_);
+            for (int i = thread_id; i < alt.k_; i += num_threads) {
+                forward.distanceToNode(alt.landmarks_[i], -1, ws);
+                for (int node = 0; node < alt.n_; ++node)
+                    alt.from_landmark_[(size_t)node * alt.k_ + i] = ws.dist(node);
+
+                backward.distanceToNode(alt.landmarks_[i], -1, ws);
+                for (int node = 0; node < alt.n_; ++node)
+                    alt.to_landmark_[(size_t)node * alt.k_ + i] = ws.dist(node);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 1; t < num_threads; ++t)
+            threads.emplace_back(work, t);
+        work(0);
+        for (auto& thread : threads)
+            thread.join();
+
+        return alt;
+    }
+
+    const std::vector<int>& landmarks() const {
+        return landmarks_;
+    }
+
+    // max over landmarks of d(L, t) - d(L, v) and d(v, L) - d(t, L). each bound is shaved by
+    // float's relative error so rounding the tables can't make it overestimate
+    double lowerBound(int node, int target) const {
+        static constexpr double FLOAT_ERROR = 1.0 / (1 << 23);
+
+        const float* from_v = &from_landmark_[(size_t)node * k_];
+        const float* from_t = &from_landmark_[(size_t)target * k_];
+        const float* to_v = &to_landmark_[(size_t)node * k_];
+        const float* to_t = &to_landmark_[(size_t)target * k_];
+
+        double bound = 0;
+        for (int i = 0; i < k_; ++i) {
+            // L reaches v but not t, or t reaches L but v doesn't: v can't reach t
+            if ((isinf(from_t[i]) && !isinf(from_v[i])) || (isinf(to_v[i]) && !isinf(to_t[i])))
+                return POS_INF;
+
+            if (!isinf(from_t[i]) && !isinf(from_v[i]))
+                bound = std::max(bound, from_t[i] - (double)from_v[i] - FLOAT_ERROR * (from_t[i] + from_v[i]));
+            if (!isinf(to_v[i]) && !isinf(to_t[i]))
+                bound = std::max(bound, to_v[i] - (double)to_t[i] - FLOAT_ERROR * (to_v[i] + to_t[i]));
+        }
+        return bound;
+    }
+
+    void save(std::ostream& out) const {
+        out.write(reinterpret_cast<const char*>(&MAGIC), sizeof(MAGIC));
+        out.write(reinterpret_cast<const char*>(&n_), sizeof(n_));
+        out.write(reinterpret_cast<const char*>(&k_), sizeof(k_));
+        out.write(reinterpret_cast<const char*>(landmarks_.data()), sizeof(int) * k_);
+        out.write(reinterpret_cast<const char*>(from_landmark_.data()), sizeof(float) * from_landmark_.size());
+        out.write(reinterpret_cast<const char*>(to_landmark_.data()), sizeof(float) * to_landmark_.size());
+    }
+
+    // graph is the one the tables will be used with, checked before anything is allocated.
+    // landmarks are distinct nodes so there are at most as many as nodes
+    static Landmarks load(std::istream& in, const CsrGraph& graph) {
+        Landmarks alt;
+        unsigned magic = 0;
+        in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+        in.read(reinterpret_cast<char*>(&alt.n_), sizeof(alt.n_));
+        in.read(reinterpret_cast<char*>(&alt.k_), sizeof(alt.k_));
+        if (!in || magic != MAGIC || alt.n_ < 0 || alt.k_ < 0)
+            throw std::runtime_error("not a landmark file");
+        if (alt.n_ != graph.numNodes() || alt.k_ > alt.n_)
+            throw std::runtime_error("landmark file is for a different graph");
+
+        alt.landmarks_.resize(alt.k_);
+        alt.from_landmark_.resize((size_t)alt.n_ * alt.k_);
+        alt.to_landmark_.resize((size_t)alt.n_ * alt.k_);
+        in.read(reinterpret_cast<char*>(alt.landmarks_.data()), sizeof(int) * alt.k_);
+        in.read(reinterpret_cast<char*>(alt.from_landmark_.data()), sizeof(float) * alt.from_landmark_.size());
+        in.read(reinterpret_cast<char*>(alt.to_landmark_.data()), sizeof(float) * alt.to_landmark_.size());
+        if (!in)
+            throw std::runtime_error("truncated landmark file");
+        for (int landmark : alt.landmarks_)
+            if (landmark < 0 || landmark >= alt.n_)
+                throw std::runtime_error("not a landmark file");
+        return alt;
+    }
+};
+
+struct LandmarkHeuristic {
+    const Landmarks* landmarks;
+
+    double operator()(int node, int target) const {
+        return landmarks->lowerBound(node, target);
+    }
+};
+
+// jump point search (harabor and grastien) on an 8 connected GridGraph where every open cell
+// costs the same. straight and diagonal runs without forced neighbours are crossed in a single
+// jump, so only the few cells where the optimal path may turn ever reach the heap. uses the
+// same moves as GridGraph, diagonals never cut a blocked corner
+class JumpPointSearch {
+private:
+    const GridGraph& grid_;
+    double step_ = 1;
+    DijkstraWorkspace<> workspace_;
+
+    bool open(int x, int y) const {
+        return grid_.passable(x, y);
+    }
+
+    static int sign(int v) {
+        return (v > 0) - (v < 0);
+    }
+
+    // octile distance, exact between two jump points and a consistent heuristic to the goal
+    double octile(int a, int b) const {
+        int dx = std::abs(a % grid_.width() - b % grid_.width());
+        int dy = std::abs(a / grid_.width() - b / grid_.width());
+        return step_ * (std::max(dx, dy) + (GridGraph::SQRT2 - 1) * std::min(dx, dy));
+    }
+
+    // walks from (x, y) towards (dx, dy) and returns the first jump point, -1 if it hits a wall
+    int jump(int x, int y, int dx, int dy, int goal) const {
+        while (true) {
+            if (open(x, y) == false)
+                return -1;
+            int node = grid_.node(x, y);
+            if (node == goal)
+                return node;
+
+            if (dx != 0 && dy != 0) {
+                // a diagonal run stops wherever one of its straight runs finds a jump point
+                if (jump(x + dx, y, dx, 0, goal) != -1 || jump(x, y + dy, 0, dy, goal) != -1)
+                    return node;
+                if (open(x + dx, y) == false || open(x, y + dy) == false)
+                    return -1;
+            } else if (dx != 0) {
+                if ((open(x, y - 1) && open(x - dx, y - 1) == false) || (open(x, y + 1) && open(x - dx, y + 1) == false))
+                    return node;
+            } else {
+                if ((open(x - 1, y) && open(x - 1, y - dy) == false) || (open(x + 1, y) && open(x + 1, y - dy) == false))
+                    return node;
+            }
+
+            x += dx;
+            y += dy;
+        }
+    }
+
+    // directions worth jumping in from node when it was reached from parent
+    void prunedDirections(int node, int parent, std::vector<std::pair<int, int>>& dirs) const {
+        dirs.clear();
+        const int x = node % grid_.width(), y = node / grid_.width();
+
+        if (parent == -1) {
+            for (int d = 0; d < 8; ++d) {
+                int dx = GridGraph::DX[d], dy = GridGraph::DY[d];
+                if (open(x + dx, y + dy) && (d < 4 || (open(x + dx, y) && open(x, y + dy))))
+                    dirs.push_back({dx, dy});
+            }
+            return;
         }
 
-        return POS_INF;
+        const int dx = sign(x - parent % grid_.width()), dy = sign(y - parent / grid_.width());
+        if (dx != 0 && dy != 0) {
+            if (open(x, y + dy))
+                dirs.push_back({0, dy});
+            if (open(x + dx, y))
+                dirs.push_back({dx, 0});
+            if (open(x, y + dy) && open(x + dx, y))
+                dirs.push_back({dx, dy});
+        } else if (dx != 0) {
+            bool up = open(x, y + 1), down = open(x, y - 1);
+            if (open(x + dx, y)) {
+                dirs.push_back({dx, 0});
+                if (up)
+                    dirs.push_back({dx, 1});
+                if (down)
+                    dirs.push_back({dx, -1});
+            }
+            if (up)
+                dirs.push_back({0, 1});
+            if (down)
+                dirs.push_back({0, -1});
+        } else {
+            bool right = open(x + 1, y), left = open(x - 1, y);
+            if (open(x, y + dy)) {
+                dirs.push_back({0, dy});
+                if (right)
+                    dirs.push_back({1, dy});
+                if (left)
+                    dirs.push_back({-1, dy});
+            }
+            if (right)
+                dirs.push_back({1, 0});
+            if (left)
+                dirs.push_back({-1, 0});
+        }
     }
 
+public:
+    JumpPointSearch(const GridGraph& grid) : grid_(grid), workspace_(grid.numNodes()) {
+        if (grid.connectivity() != 8)
+            throw std::invalid_argument("jump point search needs an 8 connected grid");
+
+        bool found = false;
+        for (int node = 0; node < grid.numNodes(); ++node) {
+            if (grid.passable(node) == false)
+                continue;
+            if (found && grid.cellCost(node) != step_)
+                throw std::invalid_argument("jump point search needs a uniform cost grid");
+            step_ = grid.cellCost(node);
+            found = true;
+        }
+    }
 
+    // a* over jump points, the returned path lists every cell
     std::pair<double, std::vector<int>> reconstructPath(int start, int end) {
+        auto& ws = workspace_;
+        ws.newQuery();
+        ws.update(start, 0, -1);
+        ws.queue_.push(start, octile(start, end));
+
+        std::vector<std::pair<int, int>> dirs;
         std::vector<int> path;
-        
-        double dist = distanceToNode(start, end);
-        if (isinf(dist) == true)
-            return {dist, path};
-        
-        int at = end;
-        while (at != start) {
-            path.push_back(at);
-            at = prev_[at];
+        while (ws.queue_.empty() == false) {
+            int id = ws.queue_.top().id;
+            ws.queue_.pop();
+            if (ws.settled(id))
+                continue;
+            ws.settle(id);
+
+            if (id == end) {
+                // fill in the straight or diagonal runs between consecutive jump points
+                for (int at = end; ws.prev(at) != -1; at = ws.prev(at)) {
+                    int from = ws.prev(at);
+                    int dx = sign(at % grid_.width() - from % grid_.width());
+                    int dy = sign(at / grid_.width() - from / grid_.width());
+                    for (int cell = at; cell != from; cell -= dy * grid_.width() + dx)
+                        path.push_back(cell);
+                }
+                path.push_back(start);
+                std::reverse(path.begin(), path.end());
+                return {ws.dist(end), path};
+            }
+
+            const int x = id % grid_.width(), y = id / grid_.width();
+            prunedDirections(id, ws.prev(id), dirs);
+            for (auto [dx, dy] : dirs) {
+                int jump_point = jump(x + dx, y + dy, dx, dy, end);
+                if (jump_point == -1 || ws.settled(jump_point))
+                    continue;
+
+                double new_dist = ws.dist(id) + octile(id, jump_point);
+                if (new_dist < ws.dist(jump_point)) {
+                    ws.update(jump_point, new_dist, id);
+                    ws.queue_.push(jump_point, new_dist + octile(jump_point, end));
+                }
+            }
         }
-        path.push_back(start);
 
-        std::reverse(path.begin(), path.end());
-        return {dist, path};
+        return {POS_INF, path};
+    }
+};
+
+// fixed set of worker threads that all run the same job and wait for each other,
+// so the many short phases of delta stepping don't pay for thread creation
+class ThreadPool {
+private:
+    int num_threads_;
+    std::vector<std::thread> workers_;
+
+    std::mutex mutex_;
+    std::condition_variable start_, done_;
+    std::function<void(int)> job_;
+    unsigned generation_ = 0;
+    int running_ = 0;
+    bool stop_ = false;
+
+    void workerLoop(int thread_id) {
+        unsigned seen = 0;
+        while (true) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            start_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_)
+                return;
+            seen = generation_;
+            lock.unlock();
+
+            job_(thread_id);
+
+            lock.lock();
+            if (--running_ == 0)
+                done_.notify_one();
+        }
+    }
+
+public:
+    ThreadPool(int num_threads) : num_threads_(std::max(1, num_threads)) {
+        // the calling thread is worker 0
+        for (int t = 1; t < num_threads_; ++t)
+            workers_.emplace_back(&ThreadPool::workerLoop, this, t);
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto& worker : workers_)
+            worker.join();
+    }
+
+    int size() const {
+        return num_threads_;
+    }
+
+    // runs job(thread_id) on every thread and returns once all of them are done
+    void run(const std::function<void(int)>& job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = job;
+            running_ = num_threads_ - 1;
+            ++generation_;
+        }
+        start_.notify_all();
+
+        job(0);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [&] { return running_ == 0; });
+    }
+};
+
+// parallel single source shortest paths (meyer and sanders). nodes are kept in buckets of
+// width delta by tentative distance. the lowest bucket is emptied by relaxing light edges
+// (cost <= delta) in parallel until it stops refilling, then the heavy edges of everything
+// it settled are relaxed once, since they can only land in later buckets
+class DeltaStepping {
+private:
+    const CsrGraph& graph_;
+    int n_;
+    double delta_;
+    ThreadPool pool_;
+
+    // graph_ split by edge weight
+    CsrGraph light_, heavy_;
+
+    std::vector<std::atomic<double>> dist_;
+
+    // buckets are cyclic, tentative distances never run more than num_buckets_ ahead of the
+    // current bucket. every thread fills its own copy so inserting needs no locking
+    int num_buckets_;
+    std::vector<std::vector<std::vector<int>>> buckets_;
+
+    // nodes being relaxed this phase, and everything settled in the current bucket
+    std::vector<int> frontier_, settled_;
+    std::vector<unsigned> stamp_;
+    unsigned epoch_ = 0;
+
+    static bool atomicMin(std::atomic<double>& target, double value) {
+        double current = target.load(std::memory_order_relaxed);
+        while (value < current) {
+            if (target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+                return true;
+        }
+        return false;
+    }
+
+    long bucketOf(double dist) const {
+        return (long)(dist / delta_);
+    }
+
+    // relaxes the edges of frontier_ in graph, each thread taking a strided share
+    void relax(const CsrGraph& graph) {
+        const int num_threads = pool_.size();
+        pool_.run([&](int thread_id) {
+            auto& buckets = buckets_[thread_id];
+            for (size_t i = thread_id; i < frontier_.size(); i += num_threads) {
+                int node = frontier_[i];
+                double d = dist_[node].load(std::memory_order_relaxed);
+                for (int j = graph.offsets[node]; j < graph.offsets[node + 1]; ++j) {
+                    int to = graph.targets[j];
+                    double new_dist = d + graph.costs[j];
+                    if (atomicMin(dist_[to], new_dist))
+                        buckets[bucketOf(new_dist) % num_buckets_].push_back(to);
+                }
+            }
+        });
+    }
+
+    static CsrGraph filterEdges(const CsrGraph& graph, const std::function<bool(double)>& keep) {
+        CsrGraph filtered;
+        filtered.offsets.push_back(0);
+        for (int node = 0; node < graph.numNodes(); ++node) {
+            for (int i = graph.offsets[node]; i < graph.offsets[node + 1]; ++i) {
+                if (keep(graph.costs[i])) {
+                    filtered.targets.push_back(graph.targets[i]);
+                    filtered.costs.push_back(graph.costs[i]);
+                }
+            }
+            filtered.offsets.push_back(filtered.targets.size());
+        }
+        return filtered;
+    }
+
+public:
+    DeltaStepping(const CsrGraph& graph, double delta, int num_threads) :
+        graph_(graph), n_(graph.numNodes()), delta_(delta), pool_(num_threads), dist_(n_), stamp_(n_, 0) {
+        if (delta <= 0)
+            throw std::invalid_argument("delta must be positive");
+
+        double max_cost = 0;
+        for (double cost : graph.costs) {
+            if (cost < 0)
+                throw std::invalid_argument("delta stepping needs non negative costs");
+            max_cost = std::max(max_cost, cost);
+        }
+
+        light_ = filterEdges(graph, [&](double cost) { return cost <= delta_; });
+        heavy_ = filterEdges(graph, [&](double cost) { return cost > delta_; });
+        num_buckets_ = bucketOf(max_cost) + 2;
+        buckets_.assign(pool_.size(), std::vector<std::vector<int>>(num_buckets_));
     }
 
+    // distances from start to every node, POS_INF where unreachable
+    std::vector<double> distances(int start) {
+        for (auto& d : dist_)
+            d.store(POS_INF, std::memory_order_relaxed);
+        dist_[start].store(0, std::memory_order_relaxed);
+        buckets_[0][0].push_back(start);
+
+        // buckets that may still hold live nodes, counted over all threads' copies
+        auto pending = [&]() {
+            for (const auto& buckets : buckets_) {
+                for (const auto& bucket : buckets) {
+                    if (bucket.empty() == false)
+                        return true;
+                }
+            }
+            return false;
+        };
+
+        for (long current = 0; pending(); ++current) {
+            const int slot = current % num_buckets_;
+            settled_.clear();
+
+            while (true) {
+                // gather the bucket, dropping nodes that have since moved to a lower bucket
+                // and duplicates. a node may come back in a later phase if its distance drops again
+                frontier_.clear();
+                if (++epoch_ == 0) {
+                    std::fill(stamp_.begin(), stamp_.end(), 0);
+                    epoch_ = 1;
+                }
+                for (auto& buckets : buckets_) {
+                    for (int node : buckets[slot]) {
+                        if (bucketOf(dist_[node].load(std::memory_order_relaxed)) == current && stamp_[node] != epoch_) {
+                            stamp_[node] = epoch_;
+                            frontier_.push_back(node);
+                        }
+                    }
+                    buckets[slot].clear();
+                }
+                if (frontier_.empty())
+                    break;
+
+                settled_.insert(settled_.end(), frontier_.begin(), frontier_.end());
+                relax(light_);
+            }
+
+            frontier_.swap(settled_);
+            std::sort(frontier_.begin(), frontier_.end());
+            frontier_.erase(std::unique(frontier_.begin(), frontier_.end()), frontier_.end());
+            relax(heavy_);
+        }
+
+        std::vector<double> dist(n_);
+        for (int node = 0; node < n_; ++node)
+            dist[node] = dist_[node].load(std::memory_order_relaxed);
+        return dist;
+    }
 };
 
+void benchmarkDeltaStepping(const std::string& name, const Graph& g, double delta) {
+    CsrGraph csr = CsrGraph::fromGraph(g);
+    auto ms = [](auto a, auto b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+
+    Dijkstra dijkstra(csr);
+    DijkstraWorkspace ws(csr.numNodes());
+    auto start = std::chrono::steady_clock::now();
+    dijkstra.distanceToNode(0, -1, ws);
+    auto end = std::chrono::steady_clock::now();
+    std::cout << name << ": dijkstra " << ms(start, end) << " ms" << std::endl;
+
+    for (int threads : {1, 2, 4, 8, 16}) {
+        DeltaStepping delta_stepping(csr, delta, threads);
+        start = std::chrono::steady_clock::now();
+        std::vector<double> dist = delta_stepping.distances(0);
+        end = std::chrono::steady_clock::now();
+
+        int wrong = 0;
+        for (int node = 0; node < csr.numNodes(); ++node)
+            wrong += std::abs(dist[node] - ws.dist(node)) > 1e-9 && dist[node] != ws.dist(node);
+        std::cout << "  delta stepping, " << threads << " threads: " << ms(start, end)
+                  << " ms, wrong distances: " << wrong << std::endl;
+    }
+}
+
+Graph randomGraph(int n, int degree) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> cost(0, 1);
+    Graph g(n);
+    for (int from = 0; from < n; ++from) {
+        for (int d = 0; d < degree; ++d) {
+            int to = rng() % n;
+            g[from].push_back({cost(rng), from, to});
+        }
+    }
+    return g;
+}
+
+Graph gridGraph(int width) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> cost(1, 10);
+    Graph g(width * width);
+    for (int y = 0; y < width; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int node = y * width + x;
+            if (x + 1 < width) {
+                g[node].push_back({cost(rng), node, node + 1});
+                g[node + 1].push_back({cost(rng), node + 1, node});
+            }
+            if (y + 1 < width) {
+                g[node].push_back({cost(rng), node, node + width});
+                g[node + width].push_back({cost(rng), node + width, node});
+            }
+        }
+    }
+    return g;
+}
+
+template <typename Queue>
+void benchmarkQueue(const std::string& name, const CsrGraph& csr, int queries) {
+    Dijkstra<Queue> dijkstra(csr);
+    typename Dijkstra<Queue>::Workspace ws(csr.numNodes());
+    std::mt19937 rng(7);
+
+    // full single source runs, the checksum should match between queues
+    double checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int q = 0; q < queries; ++q) {
+        dijkstra.distanceToNode(rng() % csr.numNodes(), -1, ws);
+        checksum += ws.dist(rng() % csr.numNodes());
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "  " << name << ": " << std::chrono::duration<double, std::milli>(end - start).count() / queries
+              << " ms/query, " << ws.queue_.pushes() / queries << " pushes, " << ws.queue_.pops() / queries
+              << " pops, checksum " << checksum << std::endl;
+}
+
+void benchmarkQueues(const std::string& name, Graph g, double scale) {
+    // scaled and rounded to integers so dial's queue applies too
+    for (auto& edges : g) {
+        for (auto& edge : edges)
+            edge.cost = std::round(edge.cost * scale);
+    }
+    CsrGraph csr = CsrGraph::fromGraph(g);
+
+    std::cout << name << ":" << std::endl;
+    benchmarkQueue<LazyBinaryHeap>("lazy binary heap", csr, 5);
+    benchmarkQueue<EagerDHeap<2>>("eager binary heap", csr, 5);
+    benchmarkQueue<EagerDHeap<4>>("eager 4-ary heap", csr, 5);
+    benchmarkQueue<RadixHeap>("radix heap", csr, 5);
+    benchmarkQueue<DialQueue>("dial", csr, 5);
+}
+
+void testKShortestPaths() {
+    // c d e f g h
+    Graph g(6); // (cost, from, to)
+    g[0].push_back({3, 0, 1});
+    g[0].push_back({2, 0, 2});
+    g[1].push_back({4, 1, 3});
+    g[2].push_back({1, 2, 1});
+    g[2].push_back({2, 2, 3});
+    g[2].push_back({3, 2, 4});
+    g[3].push_back({2, 3, 4});
+    g[3].push_back({1, 3, 5});
+    g[4].push_back({2, 4, 5});
+
+    CsrGraph csr = CsrGraph::fromGraph(g);
+    KShortestPaths yen(csr, 2);
+
+    // 5: 0 2 3 5, 7: 0 2 4 5, 8: 0 1 3 5
+    for (const auto& path : yen.find(0, 5, 3)) {
+        std::cout << "Path cost " << path.cost << ":";
+        for (int node : path.nodes)
+            std::cout << " " << node;
+        std::cout << std::endl;
+    }
+}
+
+void testDynamicShortestPaths() {
+    int n = 5;
+    Graph g(n); // (cost, from, to)
+    g[0].push_back({4, 0, 1});
+    g[0].push_back({1, 0, 2});
+    g[1].push_back({1, 1, 3});
+    g[2].push_back({2, 2, 1});
+    g[2].push_back({5, 2, 3});
+    g[3].push_back({3, 3, 4});
+
+    CsrGraph csr = CsrGraph::fromGraph(g);
+    DynamicShortestPaths tree(csr, 0);
+
+    // 2 -> 1 gets slower, the route moves to 0 1 3 4 with cost 8
+    int repaired = tree.applyBatch({{tree.edgeIndex(2, 1), 10}});
+    std::cout << "After slowdown: " << tree.dist(4) << ", repaired " << repaired << " nodes, path:";
+    for (int node : tree.path(4))
+        std::cout << " " << node;
+    std::cout << std::endl;
+
+    // 2 -> 3 gets faster, the route moves to 0 2 3 4 with cost 5
+    repaired = tree.applyBatch({{tree.edgeIndex(2, 3), 1}});
+    std::cout << "After speedup: " << tree.dist(4) << ", repaired " << repaired << " nodes, path:";
+    for (int node : tree.path(4))
+        std::cout << " " << node;
+    std::cout << std::endl;
+}
+
+void testGridGraph() {
+    // # is a wall, every other cell costs 1 to enter
+    std::vector<std::string> map = {
+        "..........",
+        "....#.....",
+        "....#.....",
+        "....####..",
+        "..........",
+    };
+    int width = map[0].size(), height = map.size();
+    std::vector<float> raster;
+    for (const auto& row : map) {
+        for (char cell : row)
+            raster.push_back(cell == '#' ? -1 : 1);
+    }
+
+    GridGraph grid(width, height, raster, 8);
+    Dijkstra<LazyBinaryHeap, GridGraph> dijkstra(grid);
+    JumpPointSearch jps(grid);
+
+    int start = grid.node(2, 2), end = grid.node(7, 1);
+    auto [cost, path] = dijkstra.reconstructPath(start, end);
+    auto [jps_cost, jps_path] = jps.reconstructPath(start, end);
+
+    // both should be 6.82843 (4 straight steps, 2 diagonal)
+    std::cout << "Grid cost: " << cost << ", jump point search cost: " << jps_cost << std::endl;
+    for (int node : jps_path)
+        map[node / width][node % width] = '*';
+    for (const auto& row : map)
+        std::cout << row << std::endl;
+}
+
+void benchmarkGrid(int width) {
+    // open grid with scattered obstacles
+    std::mt19937 rng(5);
+    std::vector<float> raster(width * width);
+    for (float& cell : raster)
+        cell = (rng() % 5 == 0) ? -1 : 1;
+    raster.front() = raster.back() = 1;
+
+    GridGraph grid(width, width, raster, 8);
+    Dijkstra<LazyBinaryHeap, GridGraph> dijkstra(grid);
+    JumpPointSearch jps(grid);
+
+    auto ms = [](auto a, auto b) { return std::chrono::duration<double, std::milli>(b - a).count(); };
+    auto t0 = std::chrono::steady_clock::now();
+    double cost = dijkstra.distanceToNode(0, width * width - 1);
+    auto t1 = std::chrono::steady_clock::now();
+    double jps_cost = jps.reconstructPath(0, width * width - 1).first;
+    auto t2 = std::chrono::steady_clock::now();
+
+    std::cout << width << "x" << width << " grid: dijkstra " << cost << " in " << ms(t0, t1)
+              << " ms, jump point search " << jps_cost << " in " << ms(t1, t2) << " ms" << std::endl;
+}
+
+void benchmarkDistanceTable(int width, int num_points, int num_threads) {
+    Graph g = gridGraph(width);
+    CsrGraph csr = CsrGraph::fromGraph(g);
+    Dijkstra dijkstra(csr);
+
+    std::mt19937 rng(3);
+    std::vector<int> points;
+    for (int i = 0; i < num_points; ++i)
+        points.push_back(rng() % csr.numNodes());
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<double> table = dijkstra.distanceTable(points, points, num_threads);
+    auto end = std::chrono::steady_clock::now();
+
+    // spot check a row against single queries
+    int wrong = 0;
+    for (int j = 0; j < num_points; ++j)
+        wrong += table[j] != dijkstra.distanceToNode(points[0], points[j]);
+
+    std::cout << num_points << " x " << num_points << " table on a " << width << "x" << width << " grid, "
+              << num_threads << " threads: " << std::chrono::duration<double, std::milli>(end - start).count()
+              << " ms, wrong distances in first row: " << wrong << std::endl;
+}
+
 int main() {
     int n = 5;
     Graph g = std::vector<std::vector<Edge>>(n); // (cost, from, to)
@@ -103,16 +2028,58 @@ int main() {
     g[2].push_back({5, 2, 3});
     g[3].push_back({3, 3, 4});
 
-
-    Dijkstra solver(g);
+    CsrGraph csr = CsrGraph::fromGraph(g);
+    CsrGraph reverse_csr = csr.reversed();
+    Dijkstra solver(csr, &reverse_csr);
     auto [cost, path] = solver.reconstructPath(0, 4);
 
     std::cout << "Cost: " << cost << std::endl; // should be 7
-    // cheapest path: 0 2 1 3 4    
-    for (int n : path) 
+    // cheapest path: 0 2 1 3 4
+    for (int n : path)
+        std::cout << n << " ";
+    std::cout << std::endl;
+
+    auto [bidirectional_cost, bidirectional_path] = solver.bidirectionalPath(0, 4);
+    std::cout << "Bidirectional cost: " << bidirectional_cost << std::endl; // should be 7
+    for (int n : bidirectional_path)
+        std::cout << n << " ";
+    std::cout << std::endl;
+
+    // landmark tables round trip through a stream the way a service would load them from disk
+    std::stringstream file;
+    Landmarks::build(csr, reverse_csr, 2, 2).save(file);
+    Landmarks landmarks = Landmarks::load(file, csr);
+
+    AStar<LandmarkHeuristic> alt(csr, LandmarkHeuristic{&landmarks});
+    auto [alt_cost, alt_path] = alt.reconstructPath(0, 4);
+    std::cout << "ALT cost: " << alt_cost << std::endl; // should be 7
+    for (int n : alt_path)
         std::cout << n << " ";
     std::cout << std::endl;
 
+    // row major, row i holds the distances from sources[i]
+    std::vector<int> sources = {0, 2}, targets = {3, 4};
+    std::vector<double> table = solver.distanceTable(sources, targets, 2);
+    std::cout << "Distance table:" << std::endl; // should be 4 7 / 3 6
+    for (size_t i = 0; i < sources.size(); ++i) {
+        for (size_t j = 0; j < targets.size(); ++j)
+            std::cout << table[i * targets.size() + j] << " ";
+        std::cout << std::endl;
+    }
+
+    benchmarkDistanceTable(100, 200, 4);
+
+    testKShortestPaths();
+    testDynamicShortestPaths();
+    testGridGraph();
+    benchmarkGrid(1000);
+
+    benchmarkQueues("random graph, queue policies", randomGraph(100000, 5), 100);
+    benchmarkQueues("grid graph, queue policies", gridGraph(300), 1);
+
+    // delta around max cost / average degree keeps buckets busy without much rework
+    benchmarkDeltaStepping("random graph", randomGraph(100000, 5), 0.2);
+    benchmarkDeltaStepping("grid graph", gridGraph(300), 10);
 
     return 0;
 }
\ No newline at end of file
@@ -1,37 +1,23 @@
 #include <vector>
 #include <iostream>
-#include <memory>
 #include <limits>
 #include <algorithm>
+#include <string>
+#include <stdexcept>
 #include <queue>
+#include <random>
+#include <chrono>
 
 struct Edge {
     int from, to;
-    std::weak_ptr<Edge> residual;
     long flow;
     long capacity;
 
-    Edge(int from, int to, long capacity) {
-        this->from = from;
-        this->to = to;
-        this->capacity = capacity;
-    }
-
-    bool isResidual() {
+    bool isResidual() const {
         return capacity == 0;
     }
-    
-    long remainingCapacity() {
-        return capacity - flow;
-    }
-
-    void augment(long bottle_neck) {
-        flow += bottle_neck;
-        auto res_ptr = residual.lock();
-        res_ptr->flow -= bottle_neck;
-    }
 
-    std::string toString(int src, int sink) {
+    std::string toString(int src, int sink) const {
         std::string u = (from == src) ? "s" : ((from == sink) ? "t" : std::to_string(from));
         std::string v = (to == src) ? "s" : ((to == sink) ? "t" : std::to_string(to));
         std::string res = "Edge " + u + " -> " + v  +
@@ -43,7 +29,13 @@ struct Edge {
 
 };
 
-using Graph = std::vector<std::vector<std::shared_ptr<Edge> > >;
+using Graph = std::vector<std::vector<Edge> >;
+
+// a src -> sink path given as edge ids, carrying flow
+struct FlowPath {
+    long flow;
+    std::vector<int> edges;
+};
 
 
 class NetworkFlowSolverBase {
@@ -52,44 +44,196 @@ protected:
 
     bool solved_ = false;
 
-    Graph graph_;
+    // flat edge arrays, an edge e and its residual edge are always stored at e and e^1
+    std::vector<int> from_, to_;
+    std::vector<long> flow_, capacity_;
+
+    // csr adjacency, edges leaving node are adj_[offsets_[node]] ... adj_[offsets_[node + 1] - 1]
+    std::vector<int> offsets_, adj_;
+    bool adjacency_built_ = false;
 
     int visited_token_ = 1;
     std::vector<int> visited_;
 
     long max_flow_ = 0;
 
+    std::vector<bool> min_cut_;
+    bool min_cut_built_ = false;
+
     void execute() {
         if (solved_)
             return;
         solved_ = true;
+        min_cut_built_ = false;
+        buildAdjacency();
         solve();
     }
 
+    // counting sort of edge ids by their from node, keeps insertion order within a node
+    void buildAdjacency() {
+        if (adjacency_built_)
+            return;
+        adjacency_built_ = true;
+
+        const int num_edges = from_.size();
+        offsets_.assign(num_nodes_ + 1, 0);
+        for (int e = 0; e < num_edges; ++e)
+            ++offsets_[from_[e] + 1];
+        for (int node = 0; node < num_nodes_; ++node)
+            offsets_[node + 1] += offsets_[node];
+
+        std::vector<int> pos(offsets_.begin(), offsets_.end() - 1);
+        adj_.resize(num_edges);
+        for (int e = 0; e < num_edges; ++e)
+            adj_[pos[from_[e]]++] = e;
+    }
+
+    long remainingCapacity(int e) const {
+        return capacity_[e] - flow_[e];
+    }
+
+    void augment(int e, long bottle_neck) {
+        flow_[e] += bottle_neck;
+        flow_[e ^ 1] -= bottle_neck;
+    }
+
+    // scratch space for repairing the flow after a capacity decrease
+    std::vector<int> repair_prev_, repair_queue_;
+
+    // bfs over residual edges from start until isTarget accepts a node, then pushes up to limit
+    // along that path. with backwards set the path ends at start instead of beginning there.
+    // only touches the nodes the bfs reaches and returns how much was pushed
+    template <typename Target>
+    long pushAlongResidualPath(int start, long limit, bool backwards, Target isTarget) {
+        ++visited_token_;
+        visited_[start] = visited_token_;
+        repair_queue_.clear();
+        repair_queue_.push_back(start);
+
+        int found = -1;
+        for (size_t head = 0; head < repair_queue_.size() && found == -1; ++head) {
+            int node = repair_queue_[head];
+            for (int i = offsets_[node]; i < offsets_[node + 1]; ++i) {
+                // going backwards, node -> to is edge e so to -> node is e^1
+                const int e = backwards ? adj_[i] ^ 1 : adj_[i];
+                const int next = backwards ? from_[e] : to_[e];
+                if (remainingCapacity(e) <= 0 || visited_[next] == visited_token_)
+                    continue;
+
+                visited_[next] = visited_token_;
+                repair_prev_[next] = e;
+                if (isTarget(next)) {
+                    found = next;
+                    break;
+                }
+                repair_queue_.push_back(next);
+            }
+        }
+        ++visited_token_;
+
+        if (found == -1)
+            return 0;
+
+        auto step = [&](int node) { return backwards ? to_[repair_prev_[node]] : from_[repair_prev_[node]]; };
+        long bottle_neck = limit;
+        for (int node = found; node != start; node = step(node))
+            bottle_neck = std::min(bottle_neck, remainingCapacity(repair_prev_[node]));
+        for (int node = found; node != start; node = step(node))
+            augment(repair_prev_[node], bottle_neck);
+
+        return bottle_neck;
+    }
+
+    // lowering the flow on edge left a surplus at its from node and a deficit at its to node.
+    // first try to reroute the surplus around the edge, anything left over is sent back
+    // to a terminal from the surplus node and pulled from a terminal into the deficit node
+    void cancelExcess(int edge, long excess) {
+        const int u = from_[edge], v = to_[edge];
+        auto isTerminal = [&](int node) { return node == src_node_ || node == sink_node_; };
+
+        long rerouted = 0;
+        while (rerouted < excess) {
+            long pushed = pushAlongResidualPath(u, excess - rerouted, false, [&](int node) { return node == v; });
+            if (pushed == 0)
+                break;
+            rerouted += pushed;
+        }
+
+        for (long surplus = isTerminal(u) ? 0 : excess - rerouted; surplus > 0; )
+            surplus -= pushAlongResidualPath(u, surplus, false, isTerminal);
+        for (long deficit = isTerminal(v) ? 0 : excess - rerouted; deficit > 0; )
+            deficit -= pushAlongResidualPath(v, deficit, true, isTerminal);
+
+        // net flow out of the source
+        max_flow_ = 0;
+        for (int i = offsets_[src_node_]; i < offsets_[src_node_ + 1]; ++i)
+            max_flow_ += flow_[adj_[i]];
+    }
+
 
 public:
     NetworkFlowSolverBase(int num_nodes, int src_node, int sink_node) :
         num_nodes_(num_nodes), src_node_(src_node), sink_node_(sink_node) {
-            graph_.resize(num_nodes);
             visited_.resize(num_nodes);
+            repair_prev_.resize(num_nodes);
     }
 
     Graph getGraph() {
         execute();
-        return graph_;
+        Graph graph(num_nodes_);
+        for (int e : adj_)
+            graph[from_[e]].push_back({from_[e], to_[e], flow_[e], capacity_[e]});
+        return graph;
     }
 
-    void addEdge(int from, int to, int capacity) {
-        if (capacity <= 0) 
-            return;
+    // returns the id of the new edge. zero capacity edges are kept so setCapacity
+    // can open them later
+    int addEdge(int from, int to, long capacity) {
+        if (capacity < 0)
+            throw std::invalid_argument("capacity must be non-negative");
+
+        from_.push_back(from);
+        to_.push_back(to);
+        flow_.push_back(0);
+        capacity_.push_back(capacity);
+
+        from_.push_back(to);
+        to_.push_back(from);
+        flow_.push_back(0);
+        capacity_.push_back(0);
 
-        auto e1 = std::make_shared<Edge>(from, to, capacity);
-        auto e2 = std::make_shared<Edge>(to, from, 0);
-        e1->residual = e2;
-        e2->residual = e1;
+        adjacency_built_ = false;
+        solved_ = false;
+        return from_.size() - 2;
+    }
 
-        graph_[from].push_back(e1);
-        graph_[to].push_back(e2);
+    // start over on the same network with new terminals, edges and capacities are kept
+    void reset(int src_node, int sink_node) {
+        src_node_ = src_node;
+        sink_node_ = sink_node;
+        std::fill(flow_.begin(), flow_.end(), 0);
+        max_flow_ = 0;
+        solved_ = false;
+    }
+
+    // edge is an id returned by addEdge. the next getMaxFlow() re-optimizes from
+    // the current flow rather than starting over
+    void setCapacity(int edge, long capacity) {
+        if (edge < 0 || edge >= (int)from_.size() || edge % 2 != 0)
+            throw std::invalid_argument("not a forward edge id");
+        if (capacity < 0)
+            throw std::invalid_argument("capacity must be non-negative");
+
+        buildAdjacency();
+        capacity_[edge] = capacity;
+
+        long excess = flow_[edge] - capacity;
+        if (excess > 0) {
+            augment(edge, -excess);
+            cancelExcess(edge, excess);
+        }
+
+        solved_ = false;
     }
 
     long getMaxFlow() {
@@ -97,6 +241,123 @@ public:
         return max_flow_;
     }
 
+    // zero copy accessors, edge ids come from addEdge (forward edges are even,
+    // e ^ 1 is the residual edge of e) and stay valid for the lifetime of the solver
+    int getNumEdges() const {
+        return from_.size();
+    }
+
+    int getFrom(int edge) const {
+        return from_[edge];
+    }
+
+    int getTo(int edge) const {
+        return to_[edge];
+    }
+
+    long getCapacity(int edge) const {
+        return capacity_[edge];
+    }
+
+    long getFlow(int edge) {
+        execute();
+        return flow_[edge];
+    }
+
+    // true for the nodes on the source side of a minimum cut, i.e. the nodes
+    // still reachable from the source in the residual graph
+    const std::vector<bool>& getMinCut() {
+        execute();
+        if (min_cut_built_)
+            return min_cut_;
+        min_cut_built_ = true;
+
+        min_cut_.assign(num_nodes_, false);
+        min_cut_[src_node_] = true;
+        std::vector<int> stack = {src_node_};
+        while (stack.empty() == false) {
+            int node = stack.back();
+            stack.pop_back();
+            for (int i = offsets_[node]; i < offsets_[node + 1]; ++i) {
+                const int e = adj_[i];
+                if (remainingCapacity(e) > 0 && min_cut_[to_[e]] == false) {
+                    min_cut_[to_[e]] = true;
+                    stack.push_back(to_[e]);
+                }
+            }
+        }
+
+        return min_cut_;
+    }
+
+    // splits the flow into at most getNumEdges() / 2 weighted src -> sink paths,
+    // flow going around cycles is dropped since it doesn't reach the sink
+    std::vector<FlowPath> getFlowPaths() {
+        execute();
+
+        std::vector<long> remaining(from_.size(), 0);
+        for (int e = 0; e < (int)from_.size(); e += 2)
+            remaining[e] = std::max(0L, flow_[e]);
+
+        std::vector<int> next(offsets_.begin(), offsets_.end() - 1);
+        // position of each node on the current walk, -1 if it's not on it
+        std::vector<int> on_walk(num_nodes_, -1);
+
+        std::vector<FlowPath> paths;
+        std::vector<int> walk;
+        while (true) {
+            int at = src_node_;
+            on_walk[at] = 0;
+            while (at != sink_node_) {
+                while (next[at] < offsets_[at + 1] && remaining[adj_[next[at]]] == 0)
+                    ++next[at];
+                if (next[at] == offsets_[at + 1])
+                    break;
+
+                const int e = adj_[next[at]];
+                if (on_walk[to_[e]] == -1) {
+                    walk.push_back(e);
+                    at = to_[e];
+                    on_walk[at] = walk.size();
+                    continue;
+                }
+
+                // closed a cycle, cancel it and resume from where it started
+                long cycle_flow = remaining[e];
+                for (int i = on_walk[to_[e]]; i < (int)walk.size(); ++i)
+                    cycle_flow = std::min(cycle_flow, remaining[walk[i]]);
+                remaining[e] -= cycle_flow;
+                for (int i = on_walk[to_[e]]; i < (int)walk.size(); ++i)
+                    remaining[walk[i]] -= cycle_flow;
+
+                while ((int)walk.size() > on_walk[to_[e]]) {
+                    on_walk[to_[walk.back()]] = -1;
+                    walk.pop_back();
+                }
+                at = to_[e];
+            }
+
+            for (int e : walk)
+                on_walk[to_[e]] = -1;
+            on_walk[src_node_] = -1;
+
+            // no more flow leaves the source
+            if (at != sink_node_)
+                break;
+
+            long path_flow = std::numeric_limits<long>::max();
+            for (int e : walk)
+                path_flow = std::min(path_flow, remaining[e]);
+            for (int e : walk)
+                remaining[e] -= path_flow;
+
+            paths.push_back({path_flow, walk});
+            walk.clear();
+        }
+
+        return paths;
+    }
+
     virtual void solve() = 0;
 
     void visit(int i) {
@@ -118,24 +379,33 @@ public:
 class DinicSolver : public NetworkFlowSolverBase {
 private:
     std::vector<int> level_;
+
+    // allows us to remember if a node lead to deadend,
+    // next_[node] is a position in the csr adjacency of node
+    std::vector<int> next_;
+
+    // bfs queue and the edges of the path currently being explored,
+    // kept as members so phases don't reallocate them
+    std::vector<int> queue_;
+    std::vector<int> path_;
     
     // constructs level graph
     // returns false if not possible
     bool constructLevelGraph() {
-        level_ = std::vector<int>(num_nodes_, -1);
+        level_.assign(num_nodes_, -1);
         level_[src_node_] = 0;
 
-        std::queue<int> q;
-        q.push(src_node_);
+        queue_.clear();
+        queue_.push_back(src_node_);
 
-        while(q.empty() == false) {
-            int node = q.front();
-            q.pop();
+        for (size_t head = 0; head < queue_.size(); ++head) {
+            int node = queue_[head];
 
-            for (auto edge_ptr : graph_[node]) {
-                if (edge_ptr->remainingCapacity() > 0 && level_[edge_ptr->to] == -1) {
-                    level_[edge_ptr->to] = level_[node] + 1;
-                    q.push(edge_ptr->to);
+            for (int i = offsets_[node]; i < offsets_[node + 1]; ++i) {
+                const int e = adj_[i];
+                if (remainingCapacity(e) > 0 && level_[to_[e]] == -1) {
+                    level_[to_[e]] = level_[node] + 1;
+                    queue_.push_back(to_[e]);
                 }
             }
         }
@@ -143,47 +413,612 @@ private:
         return level_[sink_node_] != -1;
     }
 
-    // finds augmented path and fills in bottle neck value and returns it
-    long dfs(int at, std::vector<int>& next, long flow) {
-        if (at == sink_node_)
-            return flow;
+    // iterative dfs over the level graph that augments along as many paths as it can,
+    // after each augmentation it only retreats to the tail of the first saturated edge
+    long blockingFlow() {
+        long total_flow = 0;
 
-        const int num_edges = graph_[at].size();
-        for (; next[at] < num_edges; next[at]++) {
-            auto& edge_ptr = graph_[at][next[at]];
-            long remaining_cap = edge_ptr->remainingCapacity();
-            if (remaining_cap > 0 && level_[edge_ptr->to] == level_[at] + 1) {
-                long bottle_neck = dfs(edge_ptr->to, next, std::min(flow, remaining_cap));
+        path_.clear();
+        int at = src_node_;
+        while (true) {
+            if (at == sink_node_) {
+                // find bottle neck value and the first edge it saturates
+                long bottle_neck = std::numeric_limits<long>::max();
+                int saturated = 0;
+                for (int i = 0; i < (int)path_.size(); ++i) {
+                    long remaining_cap = remainingCapacity(path_[i]);
+                    if (remaining_cap < bottle_neck) {
+                        bottle_neck = remaining_cap;
+                        saturated = i;
+                    }
+                }
+
+                for (int e : path_)
+                    augment(e, bottle_neck);
+                total_flow += bottle_neck;
+
+                path_.resize(saturated);
+                at = path_.empty() ? src_node_ : to_[path_.back()];
+                continue;
+            }
+
+            // advance along the current arc
+            for (; next_[at] < offsets_[at + 1]; next_[at]++) {
+                const int e = adj_[next_[at]];
+                if (remainingCapacity(e) > 0 && level_[to_[e]] == level_[at] + 1)
+                    break;
+            }
 
-                if (bottle_neck > 0) {
-                    edge_ptr->augment(bottle_neck);
-                    return bottle_neck;
-                } 
+            if (next_[at] < offsets_[at + 1]) {
+                const int e = adj_[next_[at]];
+                path_.push_back(e);
+                at = to_[e];
+                continue;
             }
 
+            // dead end, retreat one edge and never try that edge again this phase
+            if (at == src_node_)
+                break;
+            path_.pop_back();
+            at = path_.empty() ? src_node_ : to_[path_.back()];
+            next_[at]++;
         }
 
-        return 0;
+        return total_flow;
     }
 
 public:
     DinicSolver(int num_nodes, int src_node, int sink_node) :
         NetworkFlowSolverBase(num_nodes, src_node, sink_node) {
         level_.resize(num_nodes_);
+        next_.resize(num_nodes_);
+        queue_.reserve(num_nodes_);
     }
     
     void solve() override {
-        // allows us to remember if a node lead to deadend 
-        std::vector<int> next(num_nodes_, 0);
-        
-        static constexpr long INF = std::numeric_limits<long>::max() / 2;
-
         while (constructLevelGraph()) {
-            next = std::vector<int>(num_nodes_, 0);
-            for (long flow = dfs(src_node_, next, INF); flow != 0; flow = dfs(src_node_, next, INF)) {
-                max_flow_ += flow;
+            next_.assign(offsets_.begin(), offsets_.end() - 1);
+            max_flow_ += blockingFlow();
+        }
+    }
+
+};
+
+
+// highest label push relabel with global relabeling and the gap heuristic
+class PushRelabelSolver : public NetworkFlowSolverBase {
+private:
+    std::vector<int> height_;
+    std::vector<long> excess_;
+
+    // current arc of each node, a position in its csr adjacency
+    std::vector<int> current_;
+
+    // active nodes (positive excess) bucketed by height, heights are always < 2 * num_nodes_
+    std::vector<std::vector<int>> active_;
+    int highest_ = -1;
+
+    // doubly linked lists of all nodes with height < num_nodes_, needed to find gaps
+    std::vector<int> level_head_, level_next_, level_prev_, level_count_;
+    int max_level_ = 0;
+
+    int relabels_since_global_ = 0;
+
+    void activate(int node) {
+        active_[height_[node]].push_back(node);
+        highest_ = std::max(highest_, height_[node]);
+    }
+
+    void addToLevel(int node) {
+        int h = height_[node];
+        level_prev_[node] = -1;
+        level_next_[node] = level_head_[h];
+        if (level_head_[h] != -1)
+            level_prev_[level_head_[h]] = node;
+        level_head_[h] = node;
+        ++level_count_[h];
+        max_level_ = std::max(max_level_, h);
+    }
+
+    void removeFromLevel(int node) {
+        int h = height_[node];
+        if (level_prev_[node] != -1)
+            level_next_[level_prev_[node]] = level_next_[node];
+        else
+            level_head_[h] = level_next_[node];
+        if (level_next_[node] != -1)
+            level_prev_[level_next_[node]] = level_prev_[node];
+        --level_count_[h];
+    }
+
+    // exact distance labels: bfs to the sink over residual edges,
+    // nodes that can't reach the sink get num_nodes_ + their distance to the source
+    void globalRelabel() {
+        relabels_since_global_ = 0;
+
+        const int unlabeled = 2 * num_nodes_ - 1;
+        height_.assign(num_nodes_, unlabeled);
+
+        // the source is pinned at num_nodes_ so the sink bfs never labels it
+        height_[sink_node_] = 0;
+        height_[src_node_] = num_nodes_;
+
+        std::queue<int> q;
+        auto reverseBfs = [&](int root) {
+            q.push(root);
+            while (q.empty() == false) {
+                int node = q.front();
+                q.pop();
+
+                // edge e is node -> to, so e^1 is the edge to -> node we could push along
+                for (int i = offsets_[node]; i < offsets_[node + 1]; ++i) {
+                    const int e = adj_[i];
+                    if (remainingCapacity(e ^ 1) > 0 && height_[to_[e]] == unlabeled) {
+                        height_[to_[e]] = height_[node] + 1;
+                        q.push(to_[e]);
+                    }
+                }
+            }
+        };
+        reverseBfs(sink_node_);
+        reverseBfs(src_node_);
+
+        // rebuild bookkeeping from scratch
+        for (auto& bucket : active_)
+            bucket.clear();
+        highest_ = -1;
+        level_head_.assign(num_nodes_, -1);
+        level_count_.assign(num_nodes_, 0);
+        max_level_ = 0;
+
+        for (int node = 0; node < num_nodes_; ++node) {
+            if (height_[node] < num_nodes_)
+                addToLevel(node);
+            if (excess_[node] > 0 && node != src_node_ && node != sink_node_)
+                activate(node);
+            current_[node] = offsets_[node];
+        }
+    }
+
+    // nothing below gap can reach the sink through the nodes above it anymore,
+    // lift every node in (gap, num_nodes_) past the source
+    void gap(int gap_height) {
+        for (int h = gap_height + 1; h <= max_level_; ++h) {
+            for (int node = level_head_[h]; node != -1; node = level_next_[node])
+                height_[node] = num_nodes_ + 1;
+            level_head_[h] = -1;
+            level_count_[h] = 0;
+        }
+        max_level_ = gap_height - 1;
+    }
+
+    void relabel(int node) {
+        ++relabels_since_global_;
+
+        int old_height = height_[node];
+        if (old_height < num_nodes_) {
+            removeFromLevel(node);
+            if (level_count_[old_height] == 0)
+                gap(old_height);
+        }
+
+        int new_height = 2 * num_nodes_ - 1;
+        for (int i = offsets_[node]; i < offsets_[node + 1]; ++i) {
+            const int e = adj_[i];
+            if (remainingCapacity(e) > 0)
+                new_height = std::min(new_height, height_[to_[e]] + 1);
+        }
+
+        height_[node] = new_height;
+        if (new_height < num_nodes_)
+            addToLevel(node);
+        current_[node] = offsets_[node];
+    }
+
+    void push(int e) {
+        const int from = from_[e], to = to_[e];
+        long delta = std::min(excess_[from], remainingCapacity(e));
+        augment(e, delta);
+        excess_[from] -= delta;
+
+        if (excess_[to] == 0 && to != src_node_ && to != sink_node_)
+            activate(to);
+        excess_[to] += delta;
+    }
+
+    void discharge(int node) {
+        while (excess_[node] > 0) {
+            if (current_[node] == offsets_[node + 1]) {
+                relabel(node);
+                continue;
+            }
+
+            const int e = adj_[current_[node]];
+            if (remainingCapacity(e) > 0 && height_[node] == height_[to_[e]] + 1)
+                push(e);
+            else
+                ++current_[node];
+        }
+    }
+
+public:
+    PushRelabelSolver(int num_nodes, int src_node, int sink_node) :
+        NetworkFlowSolverBase(num_nodes, src_node, sink_node) {
+        height_.resize(num_nodes_);
+        excess_.resize(num_nodes_);
+        current_.resize(num_nodes_);
+        active_.resize(2 * num_nodes_);
+        level_next_.resize(num_nodes_);
+        level_prev_.resize(num_nodes_);
+    }
+
+    void solve() override {
+        // we may be resuming from a flow left by an earlier solve
+        // residual edges carry the negated flow, so this is inflow - outflow
+        excess_.assign(num_nodes_, 0);
+        for (int e = 0; e < (int)from_.size(); ++e)
+            excess_[from_[e]] -= flow_[e];
+
+        // saturate every edge out of the source
+        for (int i = offsets_[src_node_]; i < offsets_[src_node_ + 1]; ++i) {
+            const int e = adj_[i];
+            long cap = remainingCapacity(e);
+            if (cap > 0) {
+                augment(e, cap);
+                excess_[src_node_] -= cap;
+                excess_[to_[e]] += cap;
             }
         }
+
+        globalRelabel();
+
+        while (highest_ >= 0) {
+            auto& bucket = active_[highest_];
+            if (bucket.empty()) {
+                --highest_;
+                continue;
+            }
+
+            int node = bucket.back();
+            bucket.pop_back();
+            discharge(node);
+
+            // heights drift from the exact distances, resync them every num_nodes_ relabels
+            if (relabels_since_global_ >= num_nodes_)
+                globalRelabel();
+        }
+
+        max_flow_ = excess_[sink_node_];
+    }
+
+};
+
+
+// lets bipartite matching engines be swapped for one another,
+// left nodes are 0 ... num_left - 1 and right nodes are 0 ... num_right - 1
+class BipartiteMatchingSolver {
+public:
+    virtual ~BipartiteMatchingSolver() = default;
+
+    virtual void addEdge(int left, int right) = 0;
+
+    // size of the maximum matching
+    virtual long getMaxFlow() = 0;
+
+    // right node matched to each left node, -1 if unmatched
+    virtual std::vector<int> getMatching() = 0;
+};
+
+// hopcroft karp on flat int arrays, no residual edges. each phase finds a maximal set of
+// vertex disjoint shortest augmenting paths so only O(sqrt(V)) phases are needed
+class HopcroftKarpSolver : public BipartiteMatchingSolver {
+private:
+    static constexpr int INF = std::numeric_limits<int>::max();
+
+    int num_left_, num_right_;
+
+    bool solved_ = false;
+    long max_flow_ = 0;
+
+    // edges as added, turned into a csr adjacency of right nodes per left node before solving
+    std::vector<int> edge_left_, edge_right_;
+    std::vector<int> offsets_, adj_;
+
+    std::vector<int> match_left_, match_right_;
+
+    // bfs layer of each left node, next_ is the current arc of each left node
+    std::vector<int> dist_, next_, queue_, stack_;
+
+    // layer of the left nodes with an edge to a free right node, the shortest augmenting paths
+    // end there and a phase only augments along those
+    int free_layer_ = INF;
+
+    void buildAdjacency() {
+        offsets_.assign(num_left_ + 1, 0);
+        for (int left : edge_left_)
+            ++offsets_[left + 1];
+        for (int left = 0; left < num_left_; ++left)
+            offsets_[left + 1] += offsets_[left];
+
+        std::vector<int> pos(offsets_.begin(), offsets_.end() - 1);
+        adj_.resize(edge_left_.size());
+        for (size_t e = 0; e < edge_left_.size(); ++e)
+            adj_[pos[edge_left_[e]]++] = edge_right_[e];
+    }
+
+    // layers left nodes by alternating path length from the free left nodes, up to the first
+    // layer that reaches a free right node. returns true if there is one
+    bool bfs() {
+        queue_.clear();
+        for (int left = 0; left < num_left_; ++left) {
+            dist_[left] = (match_left_[left] == -1) ? 0 : INF;
+            if (dist_[left] == 0)
+                queue_.push_back(left);
+        }
+
+        free_layer_ = INF;
+        for (size_t head = 0; head < queue_.size(); ++head) {
+            int left = queue_[head];
+            // the rest of the queue is that layer or deeper, paths through it are longer
+            if (dist_[left] >= free_layer_)
+                break;
+            for (int i = offsets_[left]; i < offsets_[left + 1]; ++i) {
+                int next_left = match_right_[adj_[i]];
+                if (next_left == -1) {
+                    free_layer_ = dist_[left];
+                } else if (dist_[next_left] == INF) {
+                    dist_[next_left] = dist_[left] + 1;
+                    queue_.push_back(next_left);
+                }
+            }
+        }
+
+        return free_layer_ != INF;
+    }
+
+    // iterative dfs along the layers, the stack holds left nodes and
+    // each one's current arc is the right node it goes through
+    bool dfs(int root) {
+        stack_.clear();
+        stack_.push_back(root);
+
+        while (stack_.empty() == false) {
+            int left = stack_.back();
+
+            // dead end, never visit again this phase
+            if (next_[left] == offsets_[left + 1]) {
+                dist_[left] = INF;
+                stack_.pop_back();
+                if (stack_.empty() == false)
+                    ++next_[stack_.back()];
+                continue;
+            }
+
+            int right = adj_[next_[left]];
+            int next_left = match_right_[right];
+            if (next_left == -1 && dist_[left] == free_layer_) {
+                // flip the matching along the path
+                for (int l : stack_) {
+                    int r = adj_[next_[l]];
+                    match_left_[l] = r;
+                    match_right_[r] = l;
+                }
+                return true;
+            }
+
+            if (next_left != -1 && dist_[left] < free_layer_ && dist_[next_left] == dist_[left] + 1)
+                stack_.push_back(next_left);
+            else
+                ++next_[left];
+        }
+
+        return false;
+    }
+
+    void solve() {
+        buildAdjacency();
+        match_left_.assign(num_left_, -1);
+        match_right_.assign(num_right_, -1);
+        dist_.resize(num_left_);
+
+        while (bfs()) {
+            next_.assign(offsets_.begin(), offsets_.end() - 1);
+            for (int left = 0; left < num_left_; ++left) {
+                if (match_left_[left] == -1 && dfs(left))
+                    ++max_flow_;
+            }
+        }
+    }
+
+public:
+    HopcroftKarpSolver(int num_left, int num_right) :
+        num_left_(num_left), num_right_(num_right) {}
+
+    void addEdge(int left, int right) override {
+        edge_left_.push_back(left);
+        edge_right_.push_back(right);
+    }
+
+    long getMaxFlow() override {
+        if (solved_ == false) {
+            solved_ = true;
+            solve();
+        }
+        return max_flow_;
+    }
+
+    std::vector<int> getMatching() override {
+        getMaxFlow();
+        return match_left_;
+    }
+
+};
+
+// the same matching modelled as src -> left -> right -> sink and solved with DinicSolver
+class DinicMatchingSolver : public BipartiteMatchingSolver {
+private:
+    int num_left_, num_right_;
+    DinicSolver solver_;
+
+    // flow network edge id of every left -> right edge
+    std::vector<int> edge_ids_;
+    std::vector<int> edge_left_, edge_right_;
+
+public:
+    DinicMatchingSolver(int num_left, int num_right) :
+        num_left_(num_left), num_right_(num_right),
+        solver_(num_left + num_right + 2, num_left + num_right, num_left + num_right + 1) {
+        for (int left = 0; left < num_left_; ++left)
+            solver_.addEdge(num_left_ + num_right_, left, 1);
+        for (int right = 0; right < num_right_; ++right)
+            solver_.addEdge(num_left_ + right, num_left_ + num_right_ + 1, 1);
+    }
+
+    void addEdge(int left, int right) override {
+        edge_ids_.push_back(solver_.addEdge(left, num_left_ + right, 1));
+        edge_left_.push_back(left);
+        edge_right_.push_back(right);
+    }
+
+    long getMaxFlow() override {
+        return solver_.getMaxFlow();
+    }
+
+    std::vector<int> getMatching() override {
+        std::vector<int> match(num_left_, -1);
+        for (size_t i = 0; i < edge_ids_.size(); ++i) {
+            if (solver_.getFlow(edge_ids_[i]) > 0)
+                match[edge_left_[i]] = edge_right_[i];
+        }
+        return match;
+    }
+
+};
+
+
+// gomory hu tree of an undirected graph built with gusfield's algorithm: n - 1 max flow
+// calls on a single solver that is reset between calls. the minimum cut between any two
+// nodes is the lightest edge on their tree path, found with binary lifting
+template <typename Solver>
+class GomoryHuTree {
+private:
+    int n_, log_n_ = 1;
+    Solver solver_;
+
+    bool built_ = false;
+
+    // tree edge from each node to its parent, rooted at node 0
+    std::vector<int> parent_;
+    std::vector<long> weight_;
+
+    // up_[k][node] is the 2^k th ancestor of node and min_[k][node] the
+    // lightest edge on the way there
+    std::vector<int> depth_;
+    std::vector<std::vector<int>> up_;
+    std::vector<std::vector<long>> min_;
+
+    void build() {
+        built_ = true;
+        parent_.assign(n_, 0);
+        weight_.assign(n_, 0);
+
+        for (int s = 1; s < n_; ++s) {
+            int t = parent_[s];
+            solver_.reset(s, t);
+            long cut = solver_.getMaxFlow();
+            const auto& source_side = solver_.getMinCut();
+
+            weight_[s] = cut;
+            for (int node = 0; node < n_; ++node) {
+                if (node != s && source_side[node] && parent_[node] == t)
+                    parent_[node] = s;
+            }
+            if (source_side[parent_[t]]) {
+                parent_[s] = parent_[t];
+                parent_[t] = s;
+                weight_[s] = weight_[t];
+                weight_[t] = cut;
+            }
+        }
+
+        buildLifting();
+    }
+
+    void buildLifting() {
+        // parents may come after their children, so find depths with a bfs from the root
+        std::vector<std::vector<int>> children(n_);
+        for (int node = 1; node < n_; ++node)
+            children[parent_[node]].push_back(node);
+
+        depth_.assign(n_, 0);
+        std::vector<int> order = {0};
+        for (size_t i = 0; i < order.size(); ++i) {
+            for (int child : children[order[i]]) {
+                depth_[child] = depth_[order[i]] + 1;
+                order.push_back(child);
+            }
+        }
+
+        while ((1 << log_n_) < n_)
+            ++log_n_;
+
+        up_.assign(log_n_, std::vector<int>(n_));
+        min_.assign(log_n_, std::vector<long>(n_));
+        for (int node = 0; node < n_; ++node) {
+            up_[0][node] = parent_[node];
+            min_[0][node] = (node == 0) ? std::numeric_limits<long>::max() : weight_[node];
+        }
+        for (int k = 1; k < log_n_; ++k) {
+            for (int node = 0; node < n_; ++node) {
+                up_[k][node] = up_[k - 1][up_[k - 1][node]];
+                min_[k][node] = std::min(min_[k - 1][node], min_[k - 1][up_[k - 1][node]]);
+            }
+        }
+    }
+
+public:
+    GomoryHuTree(int n) : n_(n), solver_(n, 0, n > 1 ? 1 : 0) {}
+
+    void addEdge(int u, int v, long capacity) {
+        solver_.addEdge(u, v, capacity);
+        solver_.addEdge(v, u, capacity);
+        built_ = false;
+    }
+
+    // tree edge from node to its parent and its weight, the root 0 has no edge
+    std::pair<int, long> getTreeEdge(int node) {
+        if (built_ == false)
+            build();
+        return {parent_[node], weight_[node]};
+    }
+
+    // O(log n) once the tree is built
+    long minCut(int u, int v) {
+        if (built_ == false)
+            build();
+        if (u == v)
+            return std::numeric_limits<long>::max();
+
+        long cut = std::numeric_limits<long>::max();
+        if (depth_[u] < depth_[v])
+            std::swap(u, v);
+        for (int k = log_n_ - 1; k >= 0; --k) {
+            if (depth_[u] - (1 << k) >= depth_[v]) {
+                cut = std::min(cut, min_[k][u]);
+                u = up_[k][u];
+            }
+        }
+        if (u == v)
+            return cut;
+
+        for (int k = log_n_ - 1; k >= 0; --k) {
+            if (up_[k][u] != up_[k][v]) {
+                cut = std::min({cut, min_[k][u], min_[k][v]});
+                u = up_[k][u];
+                v = up_[k][v];
+            }
+        }
+        return std::min({cut, min_[0][u], min_[0][v]});
     }
 
 };
@@ -217,10 +1052,143 @@ void testSmallFlowGraph() {
 }
 
 
+void testPushRelabelSmallFlowGraph() {
+    int num_nodes = 6;
+    int src_node = num_nodes - 1;
+    int sink_node = num_nodes - 2;
+
+    PushRelabelSolver solver(num_nodes, src_node, sink_node);
+ 
+    // Source edges
+    solver.addEdge(src_node, 0, 10);
+    solver.addEdge(src_node, 1, 10);
+
+    // Sink edges
+    solver.addEdge(2, sink_node, 10);
+    solver.addEdge(3, sink_node, 10);
+
+    // Middle edges
+    solver.addEdge(0, 1, 2);
+    solver.addEdge(0, 2, 4);
+    solver.addEdge(0, 3, 8);
+    solver.addEdge(1, 3, 9);
+    solver.addEdge(3, 2, 6);
+
+    
+    // Maximum Flow is: 19
+    std::cout << "Maximum flow is: " << solver.getMaxFlow() << std::endl;
+}
+
+void testCapacityChanges() {
+    int num_nodes = 6;
+    int src_node = num_nodes - 1;
+    int sink_node = num_nodes - 2;
+
+    DinicSolver solver(num_nodes, src_node, sink_node);
+ 
+    // Source edges
+    solver.addEdge(src_node, 0, 10);
+    solver.addEdge(src_node, 1, 10);
+
+    // Sink edges
+    solver.addEdge(2, sink_node, 10);
+    solver.addEdge(3, sink_node, 10);
+
+    // Middle edges
+    solver.addEdge(0, 1, 2);
+    solver.addEdge(0, 2, 4);
+    int edge_0_to_3 = solver.addEdge(0, 3, 8);
+    int edge_1_to_3 = solver.addEdge(1, 3, 9);
+    solver.addEdge(3, 2, 6);
+
+    // Maximum Flow is: 19
+    std::cout << "Maximum flow is: " << solver.getMaxFlow() << std::endl;
+
+    // existing flow is repaired and re-optimized instead of solving from scratch
+    solver.setCapacity(edge_0_to_3, 1);
+    // Maximum Flow is: 14
+    std::cout << "Maximum flow after decrease is: " << solver.getMaxFlow() << std::endl;
+
+    solver.setCapacity(edge_1_to_3, 20);
+    // Maximum Flow is: 17
+    std::cout << "Maximum flow after increase is: " << solver.getMaxFlow() << std::endl;
+}
+
+void testBipartiteMatching() {
+    // 4 workers x 4 jobs
+    std::vector<std::vector<int>> can_do = {
+        {0, 1},
+        {0},
+        {1, 2, 3},
+        {2}
+    };
+
+    HopcroftKarpSolver hopcroft_karp(4, 4);
+    DinicMatchingSolver dinic(4, 4);
+    for (BipartiteMatchingSolver* solver : std::vector<BipartiteMatchingSolver*>{&hopcroft_karp, &dinic}) {
+        for (int left = 0; left < 4; ++left) {
+            for (int right : can_do[left])
+                solver->addEdge(left, right);
+        }
+
+        // Maximum matching is: 4
+        std::cout << "Maximum matching is: " << solver->getMaxFlow() << std::endl;
+        auto match = solver->getMatching();
+        for (int left = 0; left < 4; ++left)
+            std::cout << left << " -> " << match[left] << std::endl;
+    }
+}
+
+void testGomoryHuTree() {
+    // undirected graph from gusfield's paper
+    GomoryHuTree<DinicSolver> tree(6);
+    tree.addEdge(0, 1, 1);
+    tree.addEdge(0, 2, 7);
+    tree.addEdge(1, 2, 1);
+    tree.addEdge(1, 3, 3);
+    tree.addEdge(1, 4, 2);
+    tree.addEdge(2, 4, 4);
+    tree.addEdge(3, 4, 1);
+    tree.addEdge(3, 5, 6);
+    tree.addEdge(4, 5, 2);
+
+    for (int node = 1; node < 6; ++node) {
+        auto [parent, weight] = tree.getTreeEdge(node);
+        std::cout << "Tree edge " << node << " - " << parent << " | weight = " << weight << std::endl;
+    }
+
+    // Minimum cut between 0 and 5 is: 6
+    std::cout << "Minimum cut between 0 and 5 is: " << tree.minCut(0, 5) << std::endl;
+}
+
+template <typename Solver>
+void benchmarkBipartiteMatching(const std::string& name, int n, int degree) {
+    std::mt19937 rng(42);
+    Solver solver(n, n);
+    for (int left = 0; left < n; ++left) {
+        for (int d = 0; d < degree; ++d)
+            solver.addEdge(left, rng() % n);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    long matching = solver.getMaxFlow();
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << name << ": matching " << matching << " in "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms" << std::endl;
+}
+
 
 
 int main() {
     testSmallFlowGraph();
+    testPushRelabelSmallFlowGraph();
+    testCapacityChanges();
+    testBipartiteMatching();
+    testGomoryHuTree();
+
+    benchmarkBipartiteMatching<HopcroftKarpSolver>("hopcroft karp", 20000, 3);
+    benchmarkBipartiteMatching<DinicMatchingSolver>("dinic", 20000, 3);
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,404 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <queue>
+#include <limits>
+#include <math.h>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <random>
+#include <chrono>
+#include <string>
+
+
+struct Edge {
+    int from;
+    int to;
+    double cost;
+};
+
+// see graph/BellmanFord.cpp
+std::vector<double> bellmanFord(const std::vector<Edge>& edges, int num_vertices, int start) {
+    std::vector<double> cost_to_come(num_vertices, std::numeric_limits<double>::infinity());
+    cost_to_come[start] = 0;
+
+    bool relaxed_an_edge = true; // early stopping condition when no edges relaxed
+
+    // for each vertex, relax edge
+    for (int v = 0; v < num_vertices - 1 && relaxed_an_edge; v++) {
+        relaxed_an_edge = false;
+        for (const auto [from, to, cost] : edges) {
+            if (cost_to_come[from] + cost < cost_to_come[to]) {
+                cost_to_come[to] = cost_to_come[from] + cost;
+                relaxed_an_edge = true;
+            }
+        }
+    }
+
+    // run second time to detect negative cycles
+    relaxed_an_edge = true;
+    for (int v = 0; v < num_vertices && relaxed_an_edge; v++) {
+        relaxed_an_edge = false;
+        for (const auto [from, to, cost] : edges) {
+            if (cost_to_come[from] + cost < cost_to_come[to]) {
+                cost_to_come[to] = -std::numeric_limits<double>::max();
+                relaxed_an_edge = true;
+            }
+        }
+    }
+
+    return cost_to_come;
+}
+
+// bellman ford from a virtual source with a 0 cost edge to every node
+std::vector<double> potentials(std::vector<Edge> edges, int num_vertices) {
+    for (int node = 0; node < num_vertices; ++node)
+        edges.push_back({num_vertices, node, 0});
+    std::vector<double> cost_to_come = bellmanFord(edges, num_vertices + 1, num_vertices);
+    cost_to_come.pop_back();
+    return cost_to_come;
+}
+
+// component id of every node. iterative take on graph/TarjanStronglyConnectedComponent.cpp,
+// recursing would overflow the stack on long paths
+std::vector<int> stronglyConnectedComponents(const std::vector<int>& offsets, const std::vector<int>& to) {
+    const int n = offsets.size() - 1;
+    const int UNVISITED = -1;
+    std::vector<int> ids(n, UNVISITED), low(n), component(n, -1), edge_at(n);
+    std::vector<int> stack, call_stack;
+    int id = 0, count = 0;
+
+    for (int root = 0; root < n; ++root) {
+        if (ids[root] != UNVISITED)
+            continue;
+
+        call_stack.push_back(root);
+        ids[root] = low[root] = id++;
+        edge_at[root] = offsets[root];
+        stack.push_back(root);
+
+        while (call_stack.empty() == false) {
+            int at = call_stack.back();
+            if (edge_at[at] < offsets[at + 1]) {
+                int next = to[edge_at[at]++];
+                if (ids[next] == UNVISITED) {
+                    ids[next] = low[next] = id++;
+                    edge_at[next] = offsets[next];
+                    stack.push_back(next);
+                    call_stack.push_back(next);
+                } else if (component[next] == -1) {
+                    low[at] = std::min(low[at], ids[next]);
+                }
+                continue;
+            }
+
+            call_stack.pop_back();
+            if (call_stack.empty() == false)
+                low[call_stack.back()] = std::min(low[call_stack.back()], low[at]);
+
+            // at started a component, everything above it on the stack belongs to it
+            if (low[at] == ids[at]) {
+                while (true) {
+                    int node = stack.back();
+                    stack.pop_back();
+                    component[node] = count;
+                    if (node == at)
+                        break;
+                }
+                ++count;
+            }
+        }
+    }
+
+    return component;
+}
+
+
+// johnson's all pairs shortest paths for sparse graphs: bellman ford from a virtual source gives
+// potentials h with w(u, v) + h(u) - h(v) >= 0, then dijkstra runs on the reweighted graph from
+// every source in parallel. O(VE + V (E log V)) time, and since rows are handed out one at a time
+// only O(V) memory per thread instead of floyd warshall's O(V^2).
+//
+// negative cycles are found up front. like FloydWarshallSolver, a pair gets -inf when its path
+// can go through a negative cycle: that happens exactly when the path enters a strongly connected
+// component that holds one. those components are cut out, potentials are computed for the rest,
+// and every row marks what its source reaches through them
+class JohnsonSolver {
+private:
+    int n_;
+
+    // reweighted graph without the negative components
+    std::vector<int> offsets_, to_;
+    std::vector<double> weight_;
+
+    // the whole graph, for spreading -inf
+    std::vector<int> all_offsets_, all_to_;
+
+    std::vector<double> potential_;
+
+    bool has_negative_cycle_ = false;
+    std::vector<char> in_negative_component_;
+
+    static void buildAdjacency(const std::vector<Edge>& edges, int n, std::vector<int>& offsets,
+                               std::vector<int>& to, std::vector<double>* cost) {
+        offsets.assign(n + 1, 0);
+        for (const Edge& edge : edges)
+            ++offsets[edge.from + 1];
+        for (int node = 0; node < n; ++node)
+            offsets[node + 1] += offsets[node];
+
+        to.resize(edges.size());
+        if (cost != nullptr)
+            cost->resize(edges.size());
+        std::vector<int> pos(offsets.begin(), offsets.end() - 1);
+        for (const Edge& edge : edges) {
+            if (cost != nullptr)
+                (*cost)[pos[edge.from]] = edge.cost;
+            to[pos[edge.from]++] = edge.to;
+        }
+    }
+
+    struct Workspace {
+        std::vector<double> dist;
+        std::vector<int> stack;
+        std::priority_queue<std::pair<double, int>, std::vector<std::pair<double, int>>,
+                            std::greater<std::pair<double, int>>> pq;
+    };
+
+    // row[t] = cost of the shortest path src -> t
+    void computeRow(int src, std::vector<double>& row, Workspace& ws) const {
+        const double INF = std::numeric_limits<double>::infinity();
+        row.assign(n_, INF);
+        std::vector<int>& stack = ws.stack;
+        stack.clear();
+
+        if (in_negative_component_[src]) {
+            stack.push_back(src);
+        } else {
+            // dist is on the reweighted graph
+            ws.dist.assign(n_, INF);
+            ws.dist[src] = 0;
+            ws.pq.push({0, src});
+            while (ws.pq.empty() == false) {
+                auto [dist, node] = ws.pq.top();
+                ws.pq.pop();
+                if (dist > ws.dist[node])
+                    continue;
+                row[node] = dist - potential_[src] + potential_[node];
+
+                for (int i = offsets_[node]; i < offsets_[node + 1]; ++i) {
+                    int next = to_[i];
+                    if (dist + weight_[i] < ws.dist[next]) {
+                        ws.dist[next] = dist + weight_[i];
+                        ws.pq.push({ws.dist[next], next});
+                    }
+                }
+            }
+
+            // where the paths step into a negative component
+            if (has_negative_cycle_) {
+                for (int node = 0; node < n_; ++node) {
+                    if (isinf(row[node]))
+                        continue;
+                    for (int i = all_offsets_[node]; i < all_offsets_[node + 1]; ++i)
+                        if (in_negative_component_[all_to_[i]])
+                            stack.push_back(all_to_[i]);
+                }
+            }
+        }
+
+        // everything reachable from there can be made as cheap as we like
+        for (int node : stack)
+            row[node] = -INF;
+        while (stack.empty() == false) {
+            int node = stack.back();
+            stack.pop_back();
+            for (int i = all_offsets_[node]; i < all_offsets_[node + 1]; ++i) {
+                int next = all_to_[i];
+                if (row[next] != -INF) {
+                    row[next] = -INF;
+                    stack.push_back(next);
+                }
+            }
+        }
+    }
+
+public:
+    JohnsonSolver(const std::vector<Edge>& edges, int num_vertices) : n_(num_vertices) {
+        for (const Edge& edge : edges)
+            if (edge.from < 0 || edge.from >= n_ || edge.to < 0 || edge.to >= n_)
+                throw std::invalid_argument("edge endpoint out of range");
+
+        in_negative_component_.assign(n_, false);
+        buildAdjacency(edges, n_, all_offsets_, all_to_, nullptr);
+
+        potential_ = potentials(edges, n_);
+        has_negative_cycle_ = std::find(potential_.begin(), potential_.end(),
+                                        -std::numeric_limits<double>::max()) != potential_.end();
+
+        std::vector<Edge> kept = edges;
+        if (has_negative_cycle_) {
+            // a component has a negative cycle iff bellman ford on its own edges finds one
+            std::vector<int> component = stronglyConnectedComponents(all_offsets_, all_to_);
+            std::vector<Edge> inside;
+            for (const Edge& edge : edges)
+                if (component[edge.from] == component[edge.to])
+                    inside.push_back(edge);
+
+            std::vector<double> inside_potential = potentials(inside, n_);
+            for (int node = 0; node < n_; ++node)
+                in_negative_component_[node] = inside_potential[node] == -std::numeric_limits<double>::max();
+
+            kept.clear();
+            for (const Edge& edge : edges)
+                if (in_negative_component_[edge.from] == false && in_negative_component_[edge.to] == false)
+                    kept.push_back(edge);
+            potential_ = potentials(kept, n_);
+        }
+
+        buildAdjacency(kept, n_, offsets_, to_, &weight_);
+        for (int node = 0; node < n_; ++node) {
+            for (int i = offsets_[node]; i < offsets_[node + 1]; ++i) {
+                // can come out a hair below 0 from rounding
+                weight_[i] = std::max(0.0, weight_[i] + potential_[node] - potential_[to_[i]]);
+            }
+        }
+    }
+
+    bool hasNegativeCycle() const {
+        return has_negative_cycle_;
+    }
+
+    // nodes in a strongly connected component with a negative cycle, paths through any of them
+    // have no shortest length
+    std::vector<int> getNegativeCycleNodes() const {
+        std::vector<int> nodes;
+        for (int node = 0; node < n_; ++node)
+            if (in_negative_component_[node])
+                nodes.push_back(node);
+        return nodes;
+    }
+
+    // calls on_row(src, row) once per source, rows come from num_threads threads in no particular
+    // order but only one call runs at a time. row is only valid during the call
+    void solve(const std::function<void(int, const std::vector<double>&)>& on_row, int num_threads) const {
+        std::atomic<int> next_source(0);
+        std::mutex mutex;
+
+        auto work = [&]() {
+            Workspace ws;
+            std::vector<double> row;
+            for (int src = next_source++; src < n_; src = next_source++) {
+                computeRow(src, row, ws);
+                std::lock_guard<std::mutex> lock(mutex);
+                on_row(src, row);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int t = 1; t < num_threads; ++t)
+            threads.emplace_back(work);
+        work();
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    // n x n row major doubles, rows land at their offset as they finish
+    void solveToFile(const std::string& file_name, int num_threads) const {
+        std::ofstream out(file_name, std::ios::binary | std::ios::trunc);
+        if (out.is_open() == false)
+            throw std::runtime_error("could not open " + file_name);
+
+        solve([&](int src, const std::vector<double>& row) {
+            out.seekp((std::streamoff)src * n_ * sizeof(double));
+            out.write(reinterpret_cast<const char*>(row.data()), n_ * sizeof(double));
+        }, num_threads);
+
+        if (out.good() == false)
+            throw std::runtime_error("could not write " + file_name);
+    }
+
+    // only for graphs where the whole matrix fits in memory
+    std::vector<std::vector<double>> getCostMatrix(int num_threads = 1) const {
+        std::vector<std::vector<double>> matrix(n_);
+        solve([&](int src, const std::vector<double>& row) { matrix[src] = row; }, num_threads);
+        return matrix;
+    }
+
+};
+
+
+void testSmallGraph() {
+    // same graph as the floyd warshall demo, 4 <-> 5 is a negative cycle
+    int n = 7;
+    std::vector<Edge> edges = {
+        {0, 1, 2}, {0, 2, 5}, {0, 6, 10}, {1, 2, 2}, {1, 4, 11},
+        {2, 6, 2}, {6, 5, 11}, {4, 5, 1}, {5, 4, -2}
+    };
+
+    JohnsonSolver solver(edges, n);
+    std::cout << "negative cycle: " << solver.hasNegativeCycle() << ", nodes on it:";
+    for (int node : solver.getNegativeCycleNodes())
+        std::cout << " " << node;
+    std::cout << std::endl;
+
+    // row 0: 0 2 4 inf -inf -inf 6
+    auto matrix = solver.getCostMatrix(2);
+    for (int src = 0; src < n; ++src) {
+        std::cout << "row " << src << ":";
+        for (int dst = 0; dst < n; ++dst)
+            std::cout << " " << matrix[src][dst];
+        std::cout << std::endl;
+    }
+}
+
+void benchmarkSparse(int num_vertices, int degree, int num_threads) {
+    // non negative weights shifted by random potentials, so plenty of negative edges to reweight
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> weight(1, 10), potential(0, 5);
+    std::vector<double> p(num_vertices);
+    for (double& value : p)
+        value = potential(rng);
+
+    std::vector<Edge> edges;
+    for (int from = 0; from < num_vertices; ++from) {
+        for (int d = 0; d < degree; ++d) {
+            int to = rng() % num_vertices;
+            edges.push_back({from, to, weight(rng) + p[from] - p[to]});
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    JohnsonSolver solver(edges, num_vertices);
+
+    // only a checksum is kept, the matrix itself is never stored
+    double checksum = 0;
+    long reachable = 0;
+    solver.solve([&](int, const std::vector<double>& row) {
+        for (double dist : row) {
+            if (isinf(dist) == false) {
+                checksum += dist;
+                ++reachable;
+            }
+        }
+    }, num_threads);
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << num_vertices << " nodes, " << edges.size() << " edges, " << num_threads << " threads: "
+              << std::chrono::duration<double, std::milli>(end - start).count() << " ms, "
+              << reachable << " reachable pairs, checksum " << checksum << std::endl;
+}
+
+
+int main() {
+    testSmallGraph();
+
+    benchmarkSparse(1000, 4, 1);
+    benchmarkSparse(1000, 4, 4);
+
+    return 0;
+}
@@ -0,0 +1,549 @@
+#include <vector>
+#include <iostream>
+#include <limits>
+#include <algorithm>
+#include <string>
+#include <queue>
+#include <exception>
+#include <stdexcept>
+
+struct Edge {
+    int from, to;
+    long flow;
+    long capacity;
+    long cost;
+
+    bool isResidual() const {
+        return capacity == 0;
+    }
+
+    std::string toString(int src, int sink) const {
+        std::string u = (from == src) ? "s" : ((from == sink) ? "t" : std::to_string(from));
+        std::string v = (to == src) ? "s" : ((to == sink) ? "t" : std::to_string(to));
+        std::string res = "Edge " + u + " -> " + v  +
+                          " | flow = " + std::to_string(flow) +
+                          " | capacity = " + std::to_string(capacity) +
+                          " | cost = " + std::to_string(cost) +
+                          " | is residual = " + std::to_string(isResidual());
+        return res;
+    }
+
+};
+
+using Graph = std::vector<std::vector<Edge> >;
+
+
+// indexed d-ary min heap (see data_structures/MinIndexedDHeap.cpp) with long values,
+// key indices are node ids so dijkstra can decrease keys instead of pushing duplicates
+class MinIndexedDHeap {
+private:
+    int size_ = 0;
+    int degree_;
+
+    // position map: ki -> node #
+    std::vector<int> pm_;
+
+    // inverse map: node # -> ki
+    std::vector<int> im_;
+
+    std::vector<long> values_;
+
+    bool less(int node_num_a, int node_num_b) {
+        return values_[im_[node_num_a]] < values_[im_[node_num_b]];
+    }
+
+    void swap(int node_num_a, int node_num_b) {
+        std::swap(pm_[im_[node_num_a]], pm_[im_[node_num_b]]);
+        std::swap(im_[node_num_a], im_[node_num_b]);
+    }
+
+    void swim(int node_num) {
+        for (int parent = (node_num - 1) / degree_; node_num > 0 && less(node_num, parent); parent = (node_num - 1) / degree_) {
+            swap(node_num, parent);
+            node_num = parent;
+        }
+    }
+
+    void sink(int node_num) {
+        while (true) {
+            int smallest = node_num;
+            int from = node_num * degree_ + 1;
+            int to = std::min(size_, from + degree_);
+            for (int kid = from; kid < to; ++kid) {
+                if (less(kid, smallest))
+                    smallest = kid;
+            }
+            if (smallest == node_num)
+                return;
+            swap(node_num, smallest);
+            node_num = smallest;
+        }
+    }
+
+public:
+    MinIndexedDHeap(int degree, int max_size) : degree_(std::max(2, degree)) {
+        pm_.assign(max_size, -1);
+        im_.assign(max_size, -1);
+        values_.resize(max_size);
+    }
+
+    bool isEmpty() {
+        return size_ == 0;
+    }
+
+    bool contains(int ki) {
+        return pm_[ki] != -1;
+    }
+
+    void insert(int ki, long value) {
+        if (contains(ki))
+            throw std::invalid_argument("ki already in use");
+
+        pm_[ki] = size_;
+        im_[size_] = ki;
+        values_[ki] = value;
+        swim(size_++);
+    }
+
+    void decrease(int ki, long value) {
+        if (value < values_[ki]) {
+            values_[ki] = value;
+            swim(pm_[ki]);
+        }
+    }
+
+    int pollMinKeyIndex() {
+        if (isEmpty())
+            throw std::domain_error("heap is empty");
+
+        int min_ki = im_[0];
+        swap(0, --size_);
+        sink(0);
+        pm_[min_ki] = -1;
+        im_[size_] = -1;
+        return min_ki;
+    }
+
+    // O(size) instead of O(max_size)
+    void clear() {
+        for (int i = 0; i < size_; ++i) {
+            pm_[im_[i]] = -1;
+            im_[i] = -1;
+        }
+        size_ = 0;
+    }
+
+};
+
+
+class NetworkFlowSolverBase {
+protected:
+    int num_nodes_, src_node_, sink_node_;
+
+    bool solved_ = false;
+
+    // flat edge arrays, an edge e and its residual edge are always stored at e and e^1,
+    // the residual edge has the negated cost
+    std::vector<int> from_, to_;
+    std::vector<long> flow_, capacity_, cost_;
+
+    // csr adjacency, edges leaving node are adj_[offsets_[node]] ... adj_[offsets_[node + 1] - 1]
+    std::vector<int> offsets_, adj_;
+    bool adjacency_built_ = false;
+
+    long max_flow_ = 0;
+    long min_cost_ = 0;
+
+    void execute() {
+        if (solved_)
+            return;
+        solved_ = true;
+        buildAdjacency();
+        solve();
+    }
+
+    // counting sort of edge ids by their from node, keeps insertion order within a node
+    void buildAdjacency() {
+        if (adjacency_built_)
+            return;
+        adjacency_built_ = true;
+
+        const int num_edges = from_.size();
+        offsets_.assign(num_nodes_ + 1, 0);
+        for (int e = 0; e < num_edges; ++e)
+            ++offsets_[from_[e] + 1];
+        for (int node = 0; node < num_nodes_; ++node)
+            offsets_[node + 1] += offsets_[node];
+
+        std::vector<int> pos(offsets_.begin(), offsets_.end() - 1);
+        adj_.resize(num_edges);
+        for (int e = 0; e < num_edges; ++e)
+            adj_[pos[from_[e]]++] = e;
+    }
+
+    long remainingCapacity(int e) const {
+        return capacity_[e] - flow_[e];
+    }
+
+    void augment(int e, long bottle_neck) {
+        flow_[e] += bottle_neck;
+        flow_[e ^ 1] -= bottle_neck;
+    }
+
+    // cost of the flow currently on the forward edges
+    long flowCost() const {
+        long cost = 0;
+        for (int e = 0; e < (int)from_.size(); e += 2)
+            cost += flow_[e] * cost_[e];
+        return cost;
+    }
+
+
+public:
+    NetworkFlowSolverBase(int num_nodes, int src_node, int sink_node) :
+        num_nodes_(num_nodes), src_node_(src_node), sink_node_(sink_node) {}
+
+    Graph getGraph() {
+        execute();
+        Graph graph(num_nodes_);
+        for (int e : adj_)
+            graph[from_[e]].push_back({from_[e], to_[e], flow_[e], capacity_[e], cost_[e]});
+        return graph;
+    }
+
+    // zero capacity edges are kept like in the max flow bases (see graph/Dinic.cpp), they never
+    // carry flow
+    void addEdge(int from, int to, long capacity, long cost) {
+        if (capacity < 0)
+            throw std::invalid_argument("capacity must be non-negative");
+
+        from_.push_back(from);
+        to_.push_back(to);
+        flow_.push_back(0);
+        capacity_.push_back(capacity);
+        cost_.push_back(cost);
+
+        from_.push_back(to);
+        to_.push_back(from);
+        flow_.push_back(0);
+        capacity_.push_back(0);
+        cost_.push_back(-cost);
+
+        adjacency_built_ = false;
+    }
+
+    long getMaxFlow() {
+        execute();
+        return max_flow_;
+    }
+
+    long getMinCost() {
+        execute();
+        return min_cost_;
+    }
+
+    virtual void solve() = 0;
+
+};
+
+// successive shortest paths, each augmenting path is found by dijkstra on
+// reduced costs cost(u, v) + potential(u) - potential(v) which stay non negative
+class MinCostFlowSolver : public NetworkFlowSolverBase {
+private:
+    static constexpr long INF = std::numeric_limits<long>::max() / 2;
+
+    std::vector<long> potential_, dist_;
+    std::vector<int> prev_edge_;
+    MinIndexedDHeap heap_;
+
+    // johnson style initial potentials, only needed when there are negative costs.
+    // every node starts at 0 as if a virtual node had a 0 cost edge to it
+    void initPotentials() {
+        potential_.assign(num_nodes_, 0);
+
+        // residual edges are empty, so only forward edges matter here
+        const int num_edges = from_.size();
+        bool has_negative_cost = false;
+        for (int e = 0; e < num_edges; e += 2)
+            has_negative_cost |= cost_[e] < 0;
+        if (has_negative_cost == false)
+            return;
+
+        bool relaxed_an_edge = true;
+        for (int v = 0; v < num_nodes_ && relaxed_an_edge; ++v) {
+            relaxed_an_edge = false;
+            for (int e = 0; e < num_edges; ++e) {
+                if (remainingCapacity(e) > 0 && potential_[from_[e]] + cost_[e] < potential_[to_[e]]) {
+                    potential_[to_[e]] = potential_[from_[e]] + cost_[e];
+                    relaxed_an_edge = true;
+                }
+            }
+        }
+
+        if (relaxed_an_edge)
+            throw std::invalid_argument("graph contains a negative cost cycle");
+    }
+
+    // returns false when the sink can't be reached anymore
+    bool dijkstra() {
+        dist_.assign(num_nodes_, INF);
+        prev_edge_.assign(num_nodes_, -1);
+
+        dist_[src_node_] = 0;
+        heap_.insert(src_node_, 0);
+
+        while (heap_.isEmpty() == false) {
+            int node = heap_.pollMinKeyIndex();
+            if (node == sink_node_)
+                break;
+
+            for (int i = offsets_[node]; i < offsets_[node + 1]; ++i) {
+                const int e = adj_[i];
+                if (remainingCapacity(e) <= 0)
+                    continue;
+
+                const int to = to_[e];
+                long new_dist = dist_[node] + cost_[e] + potential_[node] - potential_[to];
+                if (new_dist < dist_[to]) {
+                    dist_[to] = new_dist;
+                    prev_edge_[to] = e;
+                    if (heap_.contains(to))
+                        heap_.decrease(to, new_dist);
+                    else
+                        heap_.insert(to, new_dist);
+                }
+            }
+        }
+        heap_.clear();
+
+        if (dist_[sink_node_] == INF)
+            return false;
+
+        // capping at the sink distance keeps reduced costs non negative even
+        // though we stopped before settling every node
+        for (int node = 0; node < num_nodes_; ++node)
+            potential_[node] += std::min(dist_[node], dist_[sink_node_]);
+
+        return true;
+    }
+
+public:
+    MinCostFlowSolver(int num_nodes, int src_node, int sink_node) :
+        NetworkFlowSolverBase(num_nodes, src_node, sink_node), heap_(4, num_nodes) {}
+
+    void solve() override {
+        initPotentials();
+
+        while (dijkstra()) {
+            // find bottle neck value
+            long bottle_neck = INF;
+            for (int e = prev_edge_[sink_node_]; e != -1; e = prev_edge_[from_[e]])
+                bottle_neck = std::min(bottle_neck, remainingCapacity(e));
+
+            // retrace augmented path and update flow
+            for (int e = prev_edge_[sink_node_]; e != -1; e = prev_edge_[from_[e]]) {
+                augment(e, bottle_neck);
+                min_cost_ += bottle_neck * cost_[e];
+            }
+
+            max_flow_ += bottle_neck;
+        }
+    }
+
+};
+
+// goldberg-tarjan cost scaling, better suited to large integer costs since the number of
+// phases is logarithmic in the largest cost. a maximum flow is found first (ignoring costs),
+// then each phase turns it into an eps-optimal flow with push relabel on the residual graph.
+// costs are multiplied by num_nodes_ so that a 1-optimal flow is optimal
+class CostScalingMinCostFlowSolver : public NetworkFlowSolverBase {
+private:
+    static constexpr int ALPHA = 8;
+
+    std::vector<long> scaled_cost_, potential_, excess_;
+    std::vector<int> current_, prev_edge_;
+
+    long reducedCost(int e) const {
+        return scaled_cost_[e] + potential_[from_[e]] - potential_[to_[e]];
+    }
+
+    // edmonds karp, costs don't matter yet
+    void findMaxFlow() {
+        std::queue<int> q;
+        while (true) {
+            prev_edge_.assign(num_nodes_, -1);
+            q.push(src_node_);
+            while (q.empty() == false) {
+                int node = q.front();
+                q.pop();
+                for (int i = offsets_[node]; i < offsets_[node + 1]; ++i) {
+                    const int e = adj_[i];
+                    const int to = to_[e];
+                    if (remainingCapacity(e) > 0 && prev_edge_[to] == -1 && to != src_node_) {
+                        prev_edge_[to] = e;
+                        q.push(to);
+                    }
+                }
+            }
+
+            if (prev_edge_[sink_node_] == -1)
+                return;
+
+            long bottle_neck = std::numeric_limits<long>::max();
+            for (int e = prev_edge_[sink_node_]; e != -1; e = prev_edge_[from_[e]])
+                bottle_neck = std::min(bottle_neck, remainingCapacity(e));
+            for (int e = prev_edge_[sink_node_]; e != -1; e = prev_edge_[from_[e]])
+                augment(e, bottle_neck);
+            max_flow_ += bottle_neck;
+        }
+    }
+
+    void push(int e, std::queue<int>& active) {
+        long delta = std::min(excess_[from_[e]], remainingCapacity(e));
+        augment(e, delta);
+        excess_[from_[e]] -= delta;
+        if (excess_[to_[e]] <= 0 && excess_[to_[e]] + delta > 0)
+            active.push(to_[e]);
+        excess_[to_[e]] += delta;
+    }
+
+    // lower the potential of node just enough that its cheapest residual edge becomes admissible
+    void relabel(int node, long eps) {
+        long highest = std::numeric_limits<long>::min();
+        for (int i = offsets_[node]; i < offsets_[node + 1]; ++i) {
+            const int e = adj_[i];
+            if (remainingCapacity(e) > 0)
+                highest = std::max(highest, potential_[to_[e]] - scaled_cost_[e]);
+        }
+        potential_[node] = highest - eps;
+        current_[node] = offsets_[node];
+    }
+
+    // turns an 2 * eps optimal flow into an eps optimal one
+    void refine(long eps) {
+        std::queue<int> active;
+
+        excess_.assign(num_nodes_, 0);
+        for (int e = 0; e < (int)from_.size(); ++e) {
+            long remaining_cap = remainingCapacity(e);
+            if (remaining_cap > 0 && reducedCost(e) < 0) {
+                augment(e, remaining_cap);
+                excess_[from_[e]] -= remaining_cap;
+                excess_[to_[e]] += remaining_cap;
+            }
+        }
+
+        for (int node = 0; node < num_nodes_; ++node) {
+            current_[node] = offsets_[node];
+            if (excess_[node] > 0)
+                active.push(node);
+        }
+
+        while (active.empty() == false) {
+            int node = active.front();
+            active.pop();
+
+            while (excess_[node] > 0) {
+                if (current_[node] == offsets_[node + 1]) {
+                    relabel(node, eps);
+                    continue;
+                }
+
+                const int e = adj_[current_[node]];
+                if (remainingCapacity(e) > 0 && reducedCost(e) < 0)
+                    push(e, active);
+                else
+                    ++current_[node];
+            }
+        }
+    }
+
+public:
+    CostScalingMinCostFlowSolver(int num_nodes, int src_node, int sink_node) :
+        NetworkFlowSolverBase(num_nodes, src_node, sink_node) {
+        current_.resize(num_nodes_);
+    }
+
+    void solve() override {
+        findMaxFlow();
+
+        long eps = 0;
+        scaled_cost_.resize(cost_.size());
+        for (int e = 0; e < (int)cost_.size(); ++e) {
+            scaled_cost_[e] = cost_[e] * num_nodes_;
+            eps = std::max(eps, std::abs(scaled_cost_[e]));
+        }
+
+        potential_.assign(num_nodes_, 0);
+        while (eps > 1) {
+            eps = std::max(1L, eps / ALPHA);
+            refine(eps);
+        }
+
+        min_cost_ = flowCost();
+    }
+
+};
+
+
+void testSmallExample() {
+    int num_nodes = 6;
+    int src_node = num_nodes - 2;
+    int sink_node = num_nodes - 1;
+
+    MinCostFlowSolver solver(num_nodes, src_node, sink_node);
+
+    // Source edges
+    solver.addEdge(src_node, 0, 4, 10);
+    solver.addEdge(src_node, 1, 2, 30);
+
+    // Middle edges
+    solver.addEdge(0, 1, 2, 10);
+    solver.addEdge(0, 2, 2, 50);
+    solver.addEdge(1, 3, 3, 20);
+    solver.addEdge(2, 3, 1, -10);
+    solver.addEdge(3, 2, 2, 15);
+
+    // Sink edges
+    solver.addEdge(2, sink_node, 5, 0);
+    solver.addEdge(3, sink_node, 1, 0);
+
+    // Maximum flow is: 5, minimum cost is: 280
+    std::cout << "Maximum flow is: " << solver.getMaxFlow() << std::endl;
+    std::cout << "Minimum cost is: " << solver.getMinCost() << std::endl;
+}
+
+void testAssignment() {
+    // 3 workers x 3 jobs
+    int n = 3;
+    std::vector<std::vector<long>> cost = {
+        {9, 2, 7},
+        {6, 4, 3},
+        {5, 8, 1}
+    };
+
+    int num_nodes = 2 * n + 2;
+    int src_node = num_nodes - 2;
+    int sink_node = num_nodes - 1;
+
+    CostScalingMinCostFlowSolver solver(num_nodes, src_node, sink_node);
+    for (int worker = 0; worker < n; ++worker) {
+        solver.addEdge(src_node, worker, 1, 0);
+        solver.addEdge(n + worker, sink_node, 1, 0);
+        for (int job = 0; job < n; ++job)
+            solver.addEdge(worker, n + job, 1, cost[worker][job]);
+    }
+
+    // Maximum flow is: 3, minimum cost is: 9
+    std::cout << "Maximum flow is: " << solver.getMaxFlow() << std::endl;
+    std::cout << "Minimum cost is: " << solver.getMinCost() << std::endl;
+}
+
+
+
+int main() {
+    testSmallExample();
+    testAssignment();
+
+    return 0;
+}